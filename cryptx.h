@@ -80,6 +80,63 @@ typedef union {
 	struct cryptx_aes_ctr_state cbc;                    /**< metadata for cbc mode */
 } cryptx_aes_private_h;
 
+/**
+ @brief @b PRIVATE -- DO NOT MODIFY
+ */
+typedef struct {
+	const void *context; void *next;
+	size_t head; size_t count;
+	uint8_t counter[16]; uint8_t tail[16];
+} cryptx_aes_prefetch_private_h;
+
+/**
+ @brief @b PRIVATE -- DO NOT MODIFY
+ */
+typedef struct {
+	uint8_t k1[16]; uint8_t k2[16];
+	uint8_t state[16];
+	uint8_t block[16]; uint8_t block_len;
+} cryptx_aes_cmac_private_h;
+
+/**
+ @brief @b PRIVATE -- DO NOT MODIFY
+ */
+typedef struct {
+	size_t aad_len; uint8_t phase;
+} cryptx_aes_etm_private_h;
+
+/**
+ @brief @b PRIVATE -- DO NOT MODIFY
+ */
+typedef struct {
+	uint8_t iv[12]; uint8_t seq[8];
+} cryptx_aes_record_private_h;
+
+/**
+ @brief @b PRIVATE -- DO NOT MODIFY
+ */
+typedef struct {
+	uint8_t peer[32]; uint8_t keys[32]; uint8_t verifier[16];
+	size_t stamp; uint8_t used;
+} cryptx_ec_session_private_h;
+
+/**
+ @brief @b PRIVATE -- DO NOT MODIFY
+ */
+typedef struct {
+	uint8_t r[16]; uint8_t s[16]; uint8_t h[17];
+	uint8_t block[16]; uint8_t block_len;
+	size_t aad_len; size_t ct_len;
+	uint8_t phase;
+	uint8_t product[33];
+} cryptx_chacha_private_h;
+
+/// Defines one segment of a scatter-gather list, as used by the @b updatev functions.
+struct cryptx_iovec {
+	const void *data;		/**< Pointer to the segment data */
+	size_t len;				/**< Length of the segment, in bytes */
+};
+
 /// Hash state context
 struct cryptx_hash_ctx {
 	bool (*init)(void* ctx);									/**< Pointer to function call for hash initialization */
@@ -115,6 +172,25 @@ bool cryptx_hash_init(struct cryptx_hash_ctx* context, uint8_t hash_alg);
  */
 void cryptx_hash_update(struct cryptx_hash_ctx* context, const void* data, size_t len);
 
+/**
+ *	@brief Updates the context for a list of non-contiguous data segments, in order.
+ *	@param context	Pointer to a context.
+ *	@param iov		Pointer to an array of segments to hash.
+ *	@param iovcnt	Number of segments in @b iov.
+ *	@note Equivalent to calling @b cryptx_hash_update once per segment, but the update
+ *	routine is looked up once and empty segments are skipped.
+ */
+void cryptx_hash_updatev(struct cryptx_hash_ctx* context, const struct cryptx_iovec *iov, size_t iovcnt);
+
+/**
+ *	@brief Updates the context for the contents of an application variable.
+ *	@param context	Pointer to a context.
+ *	@param name		Name of the appvar, up to 8 characters.
+ *	@returns True if the appvar was found, False if not.
+ *	@note Archived appvars are hashed where they are, out of flash, without being copied to RAM.
+ */
+bool cryptx_hash_update_appvar(struct cryptx_hash_ctx* context, const char* name);
+
 /**
  *	@brief Output digest for current context (preserves state).
  *	@param context	Pointer to a context.
@@ -136,6 +212,134 @@ void cryptx_hash_mgf1(const void* data,
 					  size_t outlen,
 					  uint8_t hash_alg);
 
+/// ### MERKLE TREES -- Use to verify one chunk of a large message without hashing all of it. ###
+
+#define CRYPTX_MERKLE_NODELEN	CRYPTX_DIGESTLEN_SHA256		/**< length of a tree node, a SHA-256 digest */
+#define CRYPTX_MERKLE_MAXDEPTH	24							/**< most nodes an authentication path can hold */
+
+/**
+ *	@brief Returns the size of the tree for a given number of leaves.
+ *	@param leaves	Number of chunks the data is split into.
+ *	@returns Size of the tree, in bytes.
+ */
+size_t cryptx_merkle_tree_len(size_t leaves);
+
+/**
+ *	@brief Splits data into fixed-size chunks and builds a SHA-256 hash tree over them.
+ *	@param data		Pointer to data to build the tree over.
+ *	@param len		Size of @b data. The last chunk is shorter if @b len is not a multiple of @b chunk_len.
+ *	@param chunk_len	Size of each chunk.
+ *	@param tree		Pointer to a buffer to write the tree to. Must be at least
+ *	@b cryptx_merkle_tree_len bytes for the number of chunks.
+ *	@param root		Pointer to a buffer to write the root to, or NULL.
+ *	Must be at least @b CRYPTX_MERKLE_NODELEN bytes.
+ *	@returns True if the tree was built, False if an argument was invalid.
+ *	@note The root is also the last node of @b tree.
+ */
+bool cryptx_merkle_build(const void* data, size_t len, size_t chunk_len, void* tree, void* root);
+
+/**
+ *	@brief Copies the authentication path of one chunk out of a tree.
+ *	@param tree		Pointer to a tree.
+ *	@param leaves	Number of chunks in the tree.
+ *	@param index	Index of the chunk.
+ *	@param path		Pointer to a buffer to write the path to.
+ *	Must be at least @b CRYPTX_MERKLE_MAXDEPTH * @b CRYPTX_MERKLE_NODELEN bytes.
+ *	@returns True if the path was written, False if @b index is out of range.
+ */
+bool cryptx_merkle_path(const void* tree, size_t leaves, size_t index, void* path);
+
+/**
+ *	@brief Verifies one chunk against the root of its tree.
+ *	Costs two compressions per level of the tree, as each interior node hashes 65 bytes, rather than hashing all of the data.
+ *	@param chunk	Pointer to the chunk to verify.
+ *	@param chunk_len	Size of @b chunk.
+ *	@param index	Index of the chunk.
+ *	@param leaves	Number of chunks in the tree.
+ *	@param path		Pointer to the authentication path of the chunk.
+ *	@param root		Pointer to the trusted root.
+ *	@returns True if the chunk is authentic, False if not.
+ */
+bool cryptx_merkle_verify(const void* chunk, size_t chunk_len, size_t index, size_t leaves,
+						  const void* path, const void* root);
+
+/**
+ *	@brief Replaces one chunk in a tree, rehashing only the nodes above it.
+ *	@param tree		Pointer to a tree.
+ *	@param leaves	Number of chunks in the tree.
+ *	@param index	Index of the chunk.
+ *	@param chunk	Pointer to the new chunk.
+ *	@param chunk_len	Size of @b chunk.
+ *	@returns True if the tree was updated, False if @b index is out of range.
+ *	@note The new root is the last node of @b tree.
+ */
+bool cryptx_merkle_update(void* tree, size_t leaves, size_t index, const void* chunk, size_t chunk_len);
+
+
+/// ### SIPHASH -- Use for keyed hashing of short inputs, such as hash table keys or packet IDs. ###
+
+/**
+ @brief @b PRIVATE -- DO NOT MODIFY
+ */
+typedef struct {
+	uint8_t v[4][8];		/**< holds the four words of state */
+	uint8_t block[8];		/**< holds a partial message word */
+	uint8_t block_len;		/**< holds the current length of data in block[8] */
+	uint8_t total_len;		/**< holds the low byte of the message length */
+} cryptx_siphash_private_h;
+
+/// SipHash state context
+struct cryptx_siphash_ctx {
+	uint8_t digest_len;						/**< Output length of the digest, in bytes */
+	cryptx_siphash_private_h metadata;		/**< PRIVATE, INTERNAL */
+};
+
+/// Supported SipHash variants
+enum cryptx_siphash_algorithms {
+	SIPHASH,			/**< SipHash-2-4, with a 16 byte key and an 8 byte digest */
+	HALFSIPHASH,		/**< HalfSipHash-2-4, with an 8 byte key and a 4 byte digest */
+};
+
+#define CRYPTX_KEYLEN_SIPHASH			16		/**< key length for SipHash */
+#define CRYPTX_KEYLEN_HALFSIPHASH		8		/**< key length for HalfSipHash */
+#define CRYPTX_DIGESTLEN_SIPHASH		8		/**< digest length for SipHash */
+#define CRYPTX_DIGESTLEN_HALFSIPHASH	4		/**< digest length for HalfSipHash */
+
+/**
+ *	@brief Initializes a context for SipHash or HalfSipHash with a key.
+ *	@param context	Pointer to a context.
+ *	@param key		Pointer to the key, @b CRYPTX_KEYLEN_SIPHASH or @b CRYPTX_KEYLEN_HALFSIPHASH bytes.
+ *	@param alg		The variant to use. See @b cryptx_siphash_algorithms.
+ *	@returns @b true if initialization succeeded, @b false if @b alg is invalid.
+ */
+bool cryptx_siphash_init(struct cryptx_siphash_ctx* context, const void* key, uint8_t alg);
+
+/**
+ *	@brief Updates the context for a given block of data.
+ *	@param context	Pointer to a context.
+ *	@param data		Pointer to a block of data to hash.
+ *	@param len		Size of the @b data to hash.
+ */
+void cryptx_siphash_update(struct cryptx_siphash_ctx* context, const void* data, size_t len);
+
+/**
+ *	@brief Output digest for current context (preserves state).
+ *	@param context	Pointer to a context.
+ *	@param digest	Pointer to a buffer to write digest to. Must be at least @b context.digest_len bytes.
+ */
+void cryptx_siphash_digest(struct cryptx_siphash_ctx* context, void* digest);
+
+/**
+ *	@brief Computes the SipHash or HalfSipHash digest of a block of data in one call.
+ *	@param key		Pointer to the key, @b CRYPTX_KEYLEN_SIPHASH or @b CRYPTX_KEYLEN_HALFSIPHASH bytes.
+ *	@param data		Pointer to data to hash.
+ *	@param len		Size of @b data to hash.
+ *	@param digest	Pointer to a buffer to write digest to.
+ *	@param alg		The variant to use. See @b cryptx_siphash_algorithms.
+ *	@returns @b true if the digest was written, @b false if @b alg is invalid.
+ */
+bool cryptx_siphash(const void* key, const void* data, size_t len, void* digest, uint8_t alg);
+
 
 /// ### HASH-BASED MESSAGE AUTHENTICATION CODE (HMAC) -- Use to verify data integrity and authenticity. ###
 
@@ -168,6 +372,24 @@ bool cryptx_hmac_init(struct cryptx_hmac_ctx* context,
  */
 void cryptx_hmac_update(struct cryptx_hmac_ctx* context, const void* data, size_t len);
 
+/**
+ *	@brief Updates the context for a list of non-contiguous data segments, in order.
+ *	@param context	Pointer to an HMAC-state context.
+ *	@param iov		Pointer to an array of segments to hash.
+ *	@param iovcnt	Number of segments in @b iov.
+ *	@note Equivalent to calling @b cryptx_hmac_update once per segment.
+ */
+void cryptx_hmac_updatev(struct cryptx_hmac_ctx* context, const struct cryptx_iovec *iov, size_t iovcnt);
+
+/**
+ *	@brief Updates the context for the contents of an application variable.
+ *	@param context	Pointer to an HMAC-state context.
+ *	@param name		Name of the appvar, up to 8 characters.
+ *	@returns True if the appvar was found, False if not.
+ *	@note Archived appvars are hashed where they are, out of flash, without being copied to RAM.
+ */
+bool cryptx_hmac_update_appvar(struct cryptx_hmac_ctx* context, const char* name);
+
 /**
  *	@brief Output digest for current context (preserves state).
  *	@param context	Pointer to a context.
@@ -357,6 +579,115 @@ aes_error_t cryptx_aes_decrypt(const struct cryptx_aes_ctx* context,
 							   size_t len,
 							   void* plaintext);
 
+/**
+ * @brief Performs a stateful AES encryption of a list of non-contiguous plaintext segments.
+ * The ciphertext is written contiguously, as if the segments were one buffer.
+ * @param context	Pointer to an AES cipher context.
+ * @param iov		Pointer to an array of plaintext segments.
+ * @param iovcnt	Number of segments in @b iov.
+ * @param ciphertext	Pointer to buffer to write encrypted data to.
+ * @returns An @b aes_error_t indicating the status of the AES operation.
+ * @note In CBC mode the segments are encrypted as one message and padded once at the end,
+ * so use @b cryptx_aes_get_ciphertext_len on the total length to size @b ciphertext.
+ */
+aes_error_t cryptx_aes_encryptv(const struct cryptx_aes_ctx* context,
+								const struct cryptx_iovec *iov,
+								size_t iovcnt,
+								void* ciphertext);
+
+/**
+ * @brief Performs a stateful AES decryption of a list of non-contiguous ciphertext segments.
+ * The plaintext is written contiguously, as if the segments were one buffer.
+ * @param context	Pointer to an AES cipher context.
+ * @param iov		Pointer to an array of ciphertext segments.
+ * @param iovcnt	Number of segments in @b iov.
+ * @param plaintext	Pointer to buffer to write decrypted data to.
+ * @returns An @b aes_error_t indicating the status of the AES operation.
+ * @note In CBC mode each segment must be a multiple of the block size.
+ */
+aes_error_t cryptx_aes_decryptv(const struct cryptx_aes_ctx* context,
+								const struct cryptx_iovec *iov,
+								size_t iovcnt,
+								void* plaintext);
+
+/// Receives each window of output from @b cryptx_aes_encrypt_appvar and @b cryptx_aes_decrypt_appvar.
+typedef void (*cryptx_aes_write_fn)(const void* data, size_t len, void* user);
+
+/**
+ * @brief Performs a stateful AES encryption of the contents of an application variable,
+ * one window at a time.
+ * @param context	Pointer to an AES cipher context.
+ * @param name		Name of the appvar, up to 8 characters.
+ * @param window	Pointer to a buffer to write each piece of ciphertext to.
+ * @param window_len	Size of @b window. Must hold one block, or two in CBC mode.
+ * @param write		Called with each piece of ciphertext, before @b window is reused.
+ * @param user		Passed through to @b write.
+ * @returns An @b aes_error_t indicating the status of the AES operation.
+ * @note Archived appvars are read where they are, out of flash, without being copied to RAM.
+ * @note In CBC mode the appvar is encrypted as one message and padded once at the end.
+ * @note @b write is called with interrupts disabled.
+ */
+aes_error_t cryptx_aes_encrypt_appvar(const struct cryptx_aes_ctx* context,
+									const char* name,
+									void* window, size_t window_len,
+									cryptx_aes_write_fn write, void* user);
+
+/**
+ * @brief Performs a stateful AES decryption of the contents of an application variable,
+ * one window at a time.
+ * @param context	Pointer to an AES cipher context.
+ * @param name		Name of the appvar, up to 8 characters.
+ * @param window	Pointer to a buffer to write each piece of plaintext to.
+ * @param window_len	Size of @b window. Must hold at least one block.
+ * @param write		Called with each piece of plaintext, before @b window is reused.
+ * @param user		Passed through to @b write.
+ * @returns An @b aes_error_t indicating the status of the AES operation.
+ * @note Archived appvars are read where they are, out of flash, without being copied to RAM.
+ * @note In CBC mode the padding is left on the last piece of plaintext, as with @b cryptx_aes_decrypt.
+ * @note @b write is called with interrupts disabled.
+ */
+aes_error_t cryptx_aes_decrypt_appvar(const struct cryptx_aes_ctx* context,
+									const char* name,
+									void* window, size_t window_len,
+									cryptx_aes_write_fn write, void* user);
+
+/// Ring of keystream computed ahead of time for a CTR or GCM context.
+struct cryptx_aes_prefetch {
+	uint8_t *buffer;						/**< keystream storage, set by @b cryptx_aes_prefetch_attach */
+	size_t blocks;							/**< capacity of @b buffer, in blocks */
+	cryptx_aes_prefetch_private_h metadata;	/**< PRIVATE, INTERNAL */
+};
+
+/**
+ * @brief Attaches a keystream prefetch ring to a CTR or GCM context.
+ * Once attached, encryption and decryption with @b context take keystream from the ring
+ * while it holds the next blocks, and compute it as usual when it runs dry.
+ * @param context	Pointer to an AES cipher context, in CTR or GCM mode.
+ * @param prefetch	Pointer to a ring to attach.
+ * @param buffer	Pointer to a buffer to hold the keystream.
+ * @param blocks	Size of @b buffer, in blocks of @b CRYPTX_BLOCKSIZE_AES bytes.
+ * @returns An @b aes_error_t indicating the status of the AES operation.
+ * @note Re-initializing @b context empties the ring.
+ */
+aes_error_t cryptx_aes_prefetch_attach(const struct cryptx_aes_ctx* context,
+									struct cryptx_aes_prefetch* prefetch,
+									void* buffer, size_t blocks);
+
+/**
+ * @brief Computes keystream blocks ahead of time, for use when the CPU would otherwise be idle.
+ * @param prefetch	Pointer to an attached ring.
+ * @param blocks	Maximum number of blocks to compute in this call.
+ * @returns The number of blocks now buffered.
+ */
+size_t cryptx_aes_prefetch_fill(struct cryptx_aes_prefetch* prefetch, size_t blocks);
+
+/**
+ * @brief Detaches a ring from its context and zeroes its buffer.
+ * @param prefetch	Pointer to an attached ring.
+ * @note Call this before @b prefetch, its buffer, or its context go out of scope.
+ */
+void cryptx_aes_prefetch_detach(struct cryptx_aes_prefetch* prefetch);
+
 /**
  * @brief Updates the cipher context for given AAD (Additional Authenticated Data).
  * AAD is data that is only authenticated, not encrypted.
@@ -393,6 +724,307 @@ bool cryptx_aes_verify(const struct cryptx_aes_ctx* context,
 					   const void* ciphertext, size_t ciphertext_len,
 					   uint8_t *tag);
 
+/// AES-CMAC state context
+struct cryptx_aes_cmac_ctx {
+	const struct cryptx_aes_ctx *aes;		/**< AES context whose round keys are used */
+	cryptx_aes_cmac_private_h metadata;		/**< PRIVATE, INTERNAL */
+};
+
+/**
+ * @brief Initializes an AES-CMAC (RFC 4493) state context.
+ * @param context	Pointer to an AES-CMAC context to initialize.
+ * @param aes	Pointer to an initialized AES context. Only its key is used, in any cipher mode.
+ * @returns An @b aes_error_t indicating the status of the AES operation.
+ * @note @b aes must stay in scope while @b context is in use.
+ */
+aes_error_t cryptx_aes_cmac_init(struct cryptx_aes_cmac_ctx* context,
+								 const struct cryptx_aes_ctx* aes);
+
+/**
+ * @brief Updates the AES-CMAC context for the given data.
+ * @param context	Pointer to an AES-CMAC context.
+ * @param data	Pointer to data to authenticate.
+ * @param len	Length of data to authenticate.
+ */
+void cryptx_aes_cmac_update(struct cryptx_aes_cmac_ctx* context, const void* data, size_t len);
+
+/**
+ * @brief Returns the AES-CMAC tag for data parsed so far.
+ * @param context	Pointer to an AES-CMAC context.
+ * @param tag	Pointer to a buffer to write the tag to. Must be at least @b CRYPTX_BLOCKSIZE_AES bytes large.
+ * @note @b context is left as it was, so it can be updated further.
+ */
+void cryptx_aes_cmac_digest(struct cryptx_aes_cmac_ctx* context, void* tag);
+
+/**
+ * @brief Computes the AES-CMAC tag of a message in one call.
+ * @param aes	Pointer to an initialized AES context.
+ * @param data	Pointer to data to authenticate.
+ * @param len	Length of data to authenticate.
+ * @param tag	Pointer to a buffer to write the tag to. Must be at least @b CRYPTX_BLOCKSIZE_AES bytes large.
+ * @returns An @b aes_error_t indicating the status of the AES operation.
+ */
+aes_error_t cryptx_aes_cmac(const struct cryptx_aes_ctx* aes,
+							const void* data, size_t len, void* tag);
+
+/**
+ * @brief Derives key material from the key of an AES context, with the NIST SP 800-108
+ * KDF in counter mode using AES-CMAC as the PRF.
+ * Each block of output is CMAC([i]_32 || label || 0x00 || context || [L]_32), where i counts from 1
+ * and L is @b outlen in bits, both encoded big-endian.
+ * @param aes	Pointer to an initialized AES context holding the key derivation key.
+ * @param label	Pointer to a label identifying the purpose of the derived key.
+ * @param label_len	Length of @b label.
+ * @param context	Pointer to information binding the derived key to a session, such as nonces or identities.
+ * @param context_len	Length of @b context.
+ * @param out	Pointer to a buffer to write the derived key material to.
+ * @param outlen	Number of bytes to derive.
+ * @returns An @b aes_error_t indicating the status of the AES operation.
+ */
+aes_error_t cryptx_aes_cmac_kdf(const struct cryptx_aes_ctx* aes,
+								const void* label, size_t label_len,
+								const void* context, size_t context_len,
+								void* out, size_t outlen);
+
+/// Encrypt-then-MAC state context, AES-CBC or AES-CTR authenticated with HMAC-SHA256
+struct cryptx_aes_etm_ctx {
+	struct cryptx_aes_ctx aes;				/**< cipher context */
+	struct cryptx_hmac_ctx hmac;			/**< HMAC-SHA256 context over the IV, AAD and ciphertext */
+	cryptx_aes_etm_private_h metadata;		/**< PRIVATE, INTERNAL */
+};
+
+/**
+ * @brief Initializes an encrypt-then-MAC context: an AES cipher context and an HMAC-SHA256 context
+ * that authenticates the IV, AAD and ciphertext as they pass through it.
+ * @param context	Pointer to an encrypt-then-MAC context to initialize.
+ * @param key	Pointer to an 128, 192, or 256 bit key for AES.
+ * @param keylen	The size, in bytes, of the @b key.
+ * @param mac_key	Pointer to a key for HMAC-SHA256. Use a different key than @b key.
+ * @param mac_keylen	The size, in bytes, of the @b mac_key.
+ * @param iv	Pointer to an initialization vector, as for @b cryptx_aes_init.
+ * @param ivlen	Length of the initialization vector.
+ * @param cipher_mode	@b CRYPTX_AES_CBC or @b CRYPTX_AES_CTR. GCM carries its own tag.
+ * @param flags	Flags to configure the AES context with, as for @b cryptx_aes_init.
+ * @returns An @b aes_error_t indicating the status of the AES operation.
+ */
+aes_error_t cryptx_aes_etm_init(struct cryptx_aes_etm_ctx* context,
+								const void* key, size_t keylen,
+								const void* mac_key, size_t mac_keylen,
+								const void* iv, size_t ivlen,
+								uint8_t cipher_mode, uint24_t flags);
+
+/**
+ * @brief Updates the encrypt-then-MAC context for given AAD (Additional Authenticated Data).
+ * AAD is data that is only authenticated, not encrypted. It must be given before any data is encrypted or decrypted.
+ * @param context	Pointer to an encrypt-then-MAC context.
+ * @param aad		Pointer to additional authenticated data segment.
+ * @param aad_len	Length of additional data segment.
+ * @returns An @b aes_error_t indicating the status of the AES operation.
+ */
+aes_error_t cryptx_aes_etm_update_aad(struct cryptx_aes_etm_ctx* context,
+									  const void* aad, size_t aad_len);
+
+/**
+ * @brief Encrypts data and authenticates the ciphertext in one pass, 64 bytes at a time.
+ * @param context	Pointer to an encrypt-then-MAC context.
+ * @param plaintext	Pointer to data to encrypt.
+ * @param len		Length of data at @b plaintext to encrypt.
+ * @param ciphertext	Pointer to buffer to write encrypted data to.
+ * @returns An @b aes_error_t indicating the status of the AES operation.
+ * @note In CBC mode the ciphertext is padded, as with @b cryptx_aes_encrypt,
+ * so use @b cryptx_aes_get_ciphertext_len to size @b ciphertext.
+ */
+aes_error_t cryptx_aes_etm_encrypt(struct cryptx_aes_etm_ctx* context,
+								   const void* plaintext, size_t len,
+								   void* ciphertext);
+
+/**
+ * @brief Authenticates ciphertext and decrypts it in one pass, 64 bytes at a time.
+ * @param context	Pointer to an encrypt-then-MAC context.
+ * @param ciphertext	Pointer to data to decrypt.
+ * @param len		Length of data at @b ciphertext to decrypt.
+ * @param plaintext	Pointer to buffer to write decrypted data to. May be @b ciphertext.
+ * @returns An @b aes_error_t indicating the status of the AES operation.
+ * @note Check the tag with @b cryptx_aes_etm_verify first, so nothing is decrypted unless it is authentic.
+ */
+aes_error_t cryptx_aes_etm_decrypt(struct cryptx_aes_etm_ctx* context,
+								   const void* ciphertext, size_t len,
+								   void* plaintext);
+
+/**
+ * @brief Returns the authentication tag for the IV, AAD and data processed so far.
+ * @param context	Pointer to an encrypt-then-MAC context.
+ * @param tag	Pointer to a buffer to write the tag to. Must be at least @b CRYPTX_DIGESTLEN_SHA256 bytes large.
+ * @returns An @b aes_error_t indicating the status of the AES operation.
+ * @note The context cannot be used again after this, re-initialize it for the next message.
+ */
+aes_error_t cryptx_aes_etm_digest(struct cryptx_aes_etm_ctx* context, uint8_t* tag);
+
+/**
+ * @brief Computes the tag of given AAD and ciphertext on a copy of the context, and compares it
+ * to an expected tag. The context is left ready to decrypt the same ciphertext.
+ * @param context	Pointer to an encrypt-then-MAC context that has not processed any data yet.
+ * @param aad		Pointer to associated data to authenticate, after any given to @b cryptx_aes_etm_update_aad.
+ * @param aad_len	Length of associated data to authenticate.
+ * @param ciphertext	Pointer to ciphertext to authenticate.
+ * @param ciphertext_len	Length of ciphertext to authenticate.
+ * @param tag		Pointer to expected tag to validate against.
+ * @returns TRUE if the tag matches expected, FALSE otherwise.
+ */
+bool cryptx_aes_etm_verify(const struct cryptx_aes_etm_ctx* context,
+						   const void* aad, size_t aad_len,
+						   const void* ciphertext, size_t ciphertext_len,
+						   const uint8_t* tag);
+
+/// Record protection context, AES-GCM with a nonce per record derived from a sequence number
+struct cryptx_aes_record_ctx {
+	struct cryptx_aes_ctx aes;				/**< GCM context, only used through the record functions */
+	cryptx_aes_record_private_h metadata;	/**< PRIVATE, INTERNAL */
+};
+
+#define CRYPTX_IVLEN_AES_RECORD		12		/** Defines the byte length of the static IV of a record protection context. */
+#define CRYPTX_TAGLEN_AES_RECORD	16		/** Defines the byte length of the tag at the end of each record. */
+
+/**
+ * @brief Initializes a record protection context. The key schedule is computed once, here,
+ * and each record after uses the nonce @b iv xor its 64-bit sequence number, counting from 0.
+ * @param context	Pointer to a record protection context to initialize.
+ * @param key	Pointer to an 128, 192, or 256 bit key.
+ * @param keylen	The size, in bytes, of the @b key.
+ * @param iv	Pointer to a static IV of @b CRYPTX_IVLEN_AES_RECORD bytes, the same on both ends.
+ * @returns An @b aes_error_t indicating the status of the AES operation.
+ * @note Use one context per direction, each with its own key or IV.
+ */
+aes_error_t cryptx_aes_record_init(struct cryptx_aes_record_ctx* context,
+								   const void* key, size_t keylen,
+								   const void* iv);
+
+/**
+ * @brief Seals the next record in place. A record is a header, authenticated but left as is,
+ * then the payload, encrypted, then room for the tag.
+ * @param context	Pointer to a record protection context.
+ * @param record	Pointer to the record, @b header_len + @b payload_len + @b CRYPTX_TAGLEN_AES_RECORD bytes long.
+ * @param header_len	Length of the header at the start of @b record.
+ * @param payload_len	Length of the payload after the header.
+ * @returns An @b aes_error_t indicating the status of the AES operation.
+ * @note AES_INVALID_OPERATION is returned once 2^64 - 1 records have been sealed, rather than reuse a nonce.
+ * @note A ring attached with @b cryptx_aes_prefetch_attach to @b context->aes can prefetch keystream for the next record.
+ */
+aes_error_t cryptx_aes_record_seal(struct cryptx_aes_record_ctx* context,
+								   void* record, size_t header_len, size_t payload_len);
+
+/**
+ * @brief Opens the next record in place, checking the tag before decrypting the payload.
+ * @param context	Pointer to a record protection context.
+ * @param record	Pointer to the record, @b header_len + @b payload_len + @b CRYPTX_TAGLEN_AES_RECORD bytes long.
+ * @param header_len	Length of the header at the start of @b record.
+ * @param payload_len	Length of the payload after the header.
+ * @returns An @b aes_error_t indicating the status of the AES operation.
+ * @note If the tag does not match, AES_INVALID_CIPHERTEXT is returned, the record is left as it was
+ * and the sequence number does not advance.
+ */
+aes_error_t cryptx_aes_record_open(struct cryptx_aes_record_ctx* context,
+								   void* record, size_t header_len, size_t payload_len);
+
+/// ### CHACHA20-POLY1305 ###
+/// Cipher state context for ChaCha20-Poly1305
+struct cryptx_chacha_ctx {
+	uint32_t state[16];                     /**< block function input: constants, key, block counter, nonce */
+	uint8_t keystream_pos;                  /**< number of bytes of @b keystream already used */
+	uint8_t op_assoc;                       /**< state-flag indicating if context is for encryption or decryption*/
+	uint8_t keystream[64];                  /**< keystream for the current block */
+	cryptx_chacha_private_h metadata;		/**< opague, internal context metadata */
+};
+
+#define CRYPTX_KEYLEN_CHACHA	32		/** Defines the byte length of a ChaCha20 key. */
+#define CRYPTX_NONCELEN_CHACHA	12		/** Defines the byte length of a ChaCha20-Poly1305 nonce. */
+#define CRYPTX_TAGLEN_CHACHA	16		/** Defines the byte length of a Poly1305 auth tag. */
+
+/// Defines response codes returned by the ChaCha20-Poly1305 API.
+typedef enum {
+	CHACHA_OK,                          /**< ChaCha operation completed successfully */
+	CHACHA_INVALID_ARG,                 /**< ChaCha operation failed, bad argument */
+	CHACHA_INVALID_OPERATION            /**< ChaCha operation failed, used encrypt context for decrypt or vice versa,
+										 added AAD after data, or used a context after its digest */
+} chacha_error_t;
+
+/**
+ * @brief Initializes a ChaCha20-Poly1305 cipher context to be used for encryption or decryption.
+ * @param context	Pointer to a ChaCha cipher context to initialize.
+ * @param key	Pointer to a 256 bit key to load into the context.
+ * @param keylen	The size, in bytes, of the @b key to load. Must be @b CRYPTX_KEYLEN_CHACHA.
+ * @param nonce	Pointer to a nonce. Must never be reused with the same key.
+ * @param noncelen	Length of the nonce. Must be @b CRYPTX_NONCELEN_CHACHA.
+ * @returns A @b chacha_error_t indicating the status of the ChaCha operation.
+ */
+chacha_error_t cryptx_chacha_init(struct cryptx_chacha_ctx* context,
+								  const void* key, size_t keylen,
+								  const void* nonce, size_t noncelen);
+
+/**
+ * @brief Performs a stateful ChaCha20 encryption of an arbitrary length of data and
+ * authenticates the resulting ciphertext.
+ * @param context	Pointer to a ChaCha cipher context.
+ * @param plaintext	Pointer to data to encrypt.
+ * @param len		Length of data at @b plaintext to encrypt.
+ * @param ciphertext	Pointer to buffer to write encrypted data to. May be the same as @b plaintext.
+ * @returns A @b chacha_error_t indicating the status of the ChaCha operation.
+ */
+chacha_error_t cryptx_chacha_encrypt(struct cryptx_chacha_ctx* context,
+									 const void* plaintext,
+									 size_t len,
+									 void* ciphertext);
+
+/**
+ * @brief Authenticates and performs a stateful ChaCha20 decryption of an arbitrary length of data.
+ * @param context		Pointer to a ChaCha cipher context.
+ * @param ciphertext	Pointer to data to decrypt.
+ * @param len		Length of data at @b ciphertext to decrypt.
+ * @param plaintext	Pointer to buffer to write decryped data to. May be the same as @b ciphertext.
+ * @returns A @b chacha_error_t indicating the status of the ChaCha operation.
+ */
+chacha_error_t cryptx_chacha_decrypt(struct cryptx_chacha_ctx* context,
+									 const void* ciphertext,
+									 size_t len,
+									 void* plaintext);
+
+/**
+ * @brief Updates the cipher context for given AAD (Additional Authenticated Data).
+ * AAD is data that is only authenticated, not encrypted. All AAD must be passed before
+ * any data is encrypted or decrypted.
+ * @param context	Pointer to a ChaCha context.
+ * @param aad		Pointer to additional authenticated data segment.
+ * @param aad_len	Length of additional data segment.
+ * @returns A @b chacha_error_t indicating the status of the ChaCha operation.
+ */
+chacha_error_t cryptx_chacha_update_aad(struct cryptx_chacha_ctx* context,
+										const void* aad, size_t aad_len);
+
+/**
+ * @brief Returns the authentication tag for the AAD and ciphertext parsed so far.
+ * The context cannot process more data afterwards.
+ * @param context	Pointer to a ChaCha context
+ * @param digest	Pointer to a buffer to output digest to. Must be at least @b CRYPTX_TAGLEN_CHACHA bytes large.
+ * @returns A @b chacha_error_t indicating the status of the ChaCha operation.
+ */
+chacha_error_t cryptx_chacha_digest(struct cryptx_chacha_ctx* context, uint8_t *digest);
+
+/**
+ * @brief Parses the specified AAD and ciphertext and then compares the output auth tag
+ * to an expected auth tag. The context is not modified, so it can be used to decrypt afterwards.
+ * @param context	Pointer to a ChaCha context.
+ * @param aad		Pointer to associated data to authenticate.
+ * @param aad_len	Length of associated data to authenticate.
+ * @param ciphertext	Pointer to ciphertext to authenticate.
+ * @param ciphertext_len	Length of ciphertext to authenticate.
+ * @param tag		Pointer to expected auth tag to validate against.
+ * @returns TRUE if authentication  tag matches expected, FALSE otherwise.
+ */
+bool cryptx_chacha_verify(const struct cryptx_chacha_ctx* context,
+						  const void* aad, size_t aad_len,
+						  const void* ciphertext, size_t ciphertext_len,
+						  const uint8_t *tag);
+
 /// ### RIVEST-SHAMIR-ADLEMAN (RSA) ###
 
 /// Defines response codes returned by calls to the RSA API.
@@ -425,8 +1057,77 @@ rsa_error_t cryptx_rsa_encrypt(const void* msg,
 							   void* ciphertext,
 							   uint8_t oaep_hash_alg);
 
+/// Defines a reusable RSA public key context, built once per key.
+struct cryptx_rsa_pubkey_ctx {
+	uint8_t modulus[CRYPTX_RSA_MODULUS_MAX];	/**< public modulus, big-endian, without leading zeros */
+	uint8_t r2[CRYPTX_RSA_MODULUS_MAX];			/**< R^2 mod modulus, converts a message into Montgomery form in one multiply */
+	size_t keylen;								/**< length of the modulus, in bytes */
+	uint24_t exponent;							/**< public exponent */
+	uint8_t nmi;								/**< -modulus^-1 mod 256, the Montgomery reduction constant */
+};
+
+/**
+ * @brief Initializes an RSA public key context, checking the key and precomputing the constants
+ * used by every operation with it.
+ * @param context	Pointer to an RSA public key context to initialize.
+ * @param modulus	Pointer to the public modulus, big-endian. Leading zero bytes, as in a DER integer, are skipped.
+ * @param modulus_len	Length of the public modulus, in bytes.
+ * @param exponent	Pointer to the public exponent, big-endian.
+ * @param exponent_len	Length of the public exponent, in bytes.
+ * @returns An @b rsa_error_t indicating the status of the RSA operation.
+ * @note The modulus must be odd and between 1024 and 2048 bits. The exponent must be odd, at least 3 and fit in 24 bits,
+ * which covers the common exponents 3 and 65537.
+ * @note This takes roughly as long as one call to @b cryptx_rsa_encrypt.
+ */
+rsa_error_t cryptx_rsa_pubkey_init(struct cryptx_rsa_pubkey_ctx* context,
+								   const void* modulus, size_t modulus_len,
+								   const void* exponent, size_t exponent_len);
+
+/**
+ * @brief Encrypts a message using an initialized RSA public key context.
+ * @param context	Pointer to an RSA public key context.
+ * @param msg	Pointer to a message to encrypt using RSA.
+ * @param msglen	The byte length of the @b msg.
+ * @param ciphertext 	Pointer a buffer to write the ciphertext to. Must be at least @b context->keylen bytes.
+ * @param oaep_hash_alg	The numeric ID of the hashing algorithm to use within OAEP encoding.
+ *      See @b cryptx_hash_algorithms.
+ * @returns  An @b rsa_error_t indicating the status of the RSA operation.
+ */
+rsa_error_t cryptx_rsa_pubkey_encrypt(const struct cryptx_rsa_pubkey_ctx* context,
+									  const void* msg,
+									  size_t msglen,
+									  void* ciphertext,
+									  uint8_t oaep_hash_alg);
+
+/// Defines the signature encodings supported by @b cryptx_rsa_verify.
+enum cryptx_rsa_signature_schemes {
+	RSA_PKCS1_V15,      /**< RSASSA-PKCS1-v1_5 */
+	RSA_PSS,            /**< RSASSA-PSS, MGF1 with the message hash and a salt as long as the digest */
+};
+
+struct cryptx_pkcs8_pubkey;
+
+/**
+ * @brief Verifies an RSA signature over a message hashed with the hash API.
+ * @param pubkey	Pointer to an RSA public key returned by @b cryptx_pkcs8_import_publickey.
+ * @param hash	Pointer to a hash context that the signed message has been passed through with
+ *      @b cryptx_hash_update. It is finalized by this call. SHA-256 and SHA-1 are supported.
+ * @param signature	Pointer to the signature.
+ * @param siglen	Length of the signature. Must equal the length of the modulus.
+ * @param scheme	The signature encoding. See @b cryptx_rsa_signature_schemes.
+ * @returns @b true if the signature is valid for the message and key, @b false otherwise.
+ * @returns @b false if any argument is invalid, including a @b pubkey whose object id is not RSA.
+ * @note The key is taken straight from @b pubkey->publickey.rsa_fields, with the same limits as
+ *      @b cryptx_rsa_pubkey_init.
+ */
+bool cryptx_rsa_verify(const struct cryptx_pkcs8_pubkey* pubkey,
+					   struct cryptx_hash_ctx* hash,
+					   const void* signature,
+					   size_t siglen,
+					   uint8_t scheme);
+
 
-/// ### ELLIPTIC CURVE DIFFIE-HELLMAN ###
+/// ### ELLIPTIC CURVE DIFFIE-HELLMAN AND DIGITAL SIGNATURES ###
 /// Using curve SECT233k1
 
 /** Defines the byte length of a private key used by this module. */
@@ -438,6 +1139,9 @@ rsa_error_t cryptx_rsa_encrypt(const void* msg,
 /** Defines the byte length of a secret generated by this module.  */
 #define CRYPTX_KEYLEN_EC_SECRET		CRYPTX_KEYLEN_EC_PUBKEY
 
+/** Defines the byte length of a compressed public key, x with the y bit in its unused top bit.  */
+#define CRYPTX_KEYLEN_EC_CPUBKEY	CRYPTX_KEYLEN_EC_PRIVKEY
+
 /// Defines possible response codes from calls to the EC API.
 typedef enum _ec_error {
 	EC_OK,
@@ -467,6 +1171,200 @@ ec_error_t cryptx_ec_keygen(uint8_t *privkey, uint8_t *pubkey);
  */
 ec_error_t cryptx_ec_secret(const uint8_t *privkey, const uint8_t *rpubkey, uint8_t *secret);
 
+/**
+ * @brief Compresses a public key to its x coordinate and one bit of y.
+ * @param pubkey	Pointer to EC public key.
+ * @param cpubkey	Pointer to buffer to write the compressed key to. Must be at least @b CRYPTX_KEYLEN_EC_CPUBKEY bytes.
+ * @returns A response code indicating the return status of this function.
+ * @note Send the compressed key instead of the public key to halve what a key agreement exchanges.
+ */
+ec_error_t cryptx_ec_compress(const uint8_t *pubkey, uint8_t *cpubkey);
+
+/**
+ * @brief Recovers a public key from its compressed form.
+ * @param cpubkey	Pointer to compressed public key.
+ * @param pubkey	Pointer to buffer to write the public key to.
+ * @returns @b EC_RPUBKEY_INVALID if no point on the curve has this x coordinate.
+ * @returns A response code indicating the return status of this function.
+ * @note This solves a quadratic over the field with a half-trace, which costs about as much
+ * as one field inversion and 233 squarings. It is still far cheaper than @b cryptx_ec_secret.
+ */
+ec_error_t cryptx_ec_decompress(const uint8_t *cpubkey, uint8_t *pubkey);
+
+/**
+ * @brief Computes an ECDH secret given a private key and a compressed remote public key.
+ * @param privkey	Pointer to local private key.
+ * @param rcpubkey	Pointer to compressed remote public key.
+ * @param secret	Pointer to buffer to write shared secret to.
+ * @returns An @b ECDH secret, the same as @b cryptx_ec_secret with the decompressed key.
+ * @returns A response code indicating the return status of this function.
+ */
+ec_error_t cryptx_ec_secret_compressed(const uint8_t *privkey, const uint8_t *rcpubkey, uint8_t *secret);
+
+/**
+ * @brief Computes ECDH secrets with many remote public keys at once.
+ * @param privkey	Pointer to local private key.
+ * @param rpubkeys	Pointer to @b count remote public keys, one after another.
+ * @param secrets	Pointer to buffer to write @b count shared secrets to, one after another.
+ * @param count	Number of remote public keys.
+ * @returns The same secrets as @b cryptx_ec_secret with each remote public key.
+ * @returns @b EC_RPUBKEY_INVALID if any remote public key is invalid. The secret for that key is
+ * all zeros, and the secrets for the other keys are still computed.
+ * @returns A response code indicating the return status of this function.
+ * @note The keys are processed in groups of up to 16. Within a group, each step of the scalar
+ * multiplication inverts one field element for the whole group, not one per key.
+ */
+ec_error_t cryptx_ec_secret_batch(const uint8_t *privkey, const uint8_t *rpubkeys, uint8_t *secrets, size_t count);
+
+/** Defines the byte length of an ECDSA signature, r || s, each big-endian. */
+#define CRYPTX_SIGLEN_ECDSA		58
+
+struct cryptx_pkcs8_privkey;
+
+/**
+ * @brief Converts a SECT233k1 public key imported with @b cryptx_pkcs8_import_publickey
+ * to the public key format of this module.
+ * @param key	Pointer to an imported public key.
+ * @param pubkey	Pointer to EC public key buffer.
+ * @returns A response code indicating the return status of this function.
+ * @note The point is not checked here. @b cryptx_ec_secret and @b cryptx_ecdsa_verify check it when it is used.
+ */
+ec_error_t cryptx_ec_import_publickey(const struct cryptx_pkcs8_pubkey *key, uint8_t *pubkey);
+
+/**
+ * @brief Converts a SECT233k1 private key imported with @b cryptx_pkcs8_import_privatekey
+ * to the private key format of this module.
+ * @param key	Pointer to an imported private key.
+ * @param privkey	Pointer to EC private key buffer.
+ * @returns A response code indicating the return status of this function.
+ */
+ec_error_t cryptx_ec_import_privatekey(const struct cryptx_pkcs8_privkey *key, uint8_t *privkey);
+
+/**
+ * @brief Signs a message digest using the elliptic curve digital signature algorithm (ECDSA).
+ * @param privkey	Pointer to local private key.
+ * @param digest	Pointer to the digest of the message to sign.
+ * @param digestlen	Length of the @b digest. Digests longer than 29 bytes are truncated to their first 29 bytes.
+ * @param signature	Pointer to buffer to write the signature to. Must be at least @b CRYPTX_SIGLEN_ECDSA bytes.
+ * @returns A response code indicating the return status of this function.
+ * @note The nonce is derived from the key and the digest as in RFC 6979, using HMAC-SHA256, so
+ * signing does not depend on the quality of the random number generator.
+ */
+ec_error_t cryptx_ecdsa_sign(const uint8_t *privkey, const void *digest, size_t digestlen, uint8_t *signature);
+
+/**
+ * @brief Verifies an ECDSA signature over a message digest.
+ * @param pubkey	Pointer to the signer's public key.
+ * @param digest	Pointer to the digest of the signed message.
+ * @param digestlen	Length of the @b digest.
+ * @param signature	Pointer to the signature, @b CRYPTX_SIGLEN_ECDSA bytes.
+ * @returns @b true if the signature is valid for the digest and key, @b false otherwise.
+ * @note The two scalar multiplications of verification share their point doublings,
+ * so this takes little more time than one @b cryptx_ec_secret.
+ */
+bool cryptx_ecdsa_verify(const uint8_t *pubkey, const void *digest, size_t digestlen, const uint8_t *signature);
+
+/// ### X25519 KEY AGREEMENT ###
+/// Using Curve25519, as in RFC 7748
+
+/** Defines the byte length of an X25519 private key, public key or secret. */
+#define CRYPTX_KEYLEN_X25519		32
+
+/**
+ * @brief Generates a pair of public/private keys for X25519.
+ * @param privkey	Pointer to X25519 private key buffer.
+ * @param pubkey	Pointer to X25519 public key buffer.
+ * @returns A random 32-byte private key and the associated public key, both little-endian.
+ * @returns A response code indicating the return status of this function.
+ */
+ec_error_t cryptx_x25519_keygen(uint8_t *privkey, uint8_t *pubkey);
+
+/**
+ * @brief Computes a secret given a private key and remote public key using X25519.
+ * @param privkey	Pointer to local private key.
+ * @param rpubkey	Pointer to remote public key.
+ * @param secret	Pointer to buffer to write shared secret to.
+ * @returns An X25519 secret for use with a symmetric encryption algorithm, after hashing.
+ * @returns A response code indicating the return status of this function.
+ * @note @b EC_RPUBKEY_INVALID is returned for a public key of small order, which gives a secret of all zeros.
+ * The time taken does not depend on the private key.
+ */
+ec_error_t cryptx_x25519_secret(const uint8_t *privkey, const uint8_t *rpubkey, uint8_t *secret);
+
+/// ### ECDH SESSION CACHE ###
+
+/** Defines the byte length of the session keys kept for each peer. */
+#define CRYPTX_KEYLEN_EC_SESSION	32
+
+/** Defines the byte length of the ticket a peer presents to resume its session. */
+#define CRYPTX_TICKETLEN_EC_SESSION	16
+
+/// One cached session, stored encrypted
+struct cryptx_ec_session {
+	cryptx_ec_session_private_h metadata;	/**< PRIVATE, INTERNAL */
+};
+
+/// Bounded cache of session keys derived from key agreements, keyed by the peer's public key
+struct cryptx_ec_session_cache {
+	struct cryptx_ec_session *entries;		/**< storage for the cached sessions, set by @b cryptx_ec_session_init */
+	size_t count;							/**< capacity of @b entries */
+	size_t clock;							/**< PRIVATE, counts uses for least-recently-used eviction */
+	struct cryptx_hmac_ctx device_mac;		/**< PRIVATE, HMAC-SHA256 keyed with the device key */
+};
+
+/**
+ * @brief Initializes an empty session cache.
+ * @param cache	Pointer to a session cache to initialize.
+ * @param entries	Pointer to storage for @b count sessions. It is zeroed.
+ * @param count	Maximum number of sessions to keep. Storing more evicts the least recently used one.
+ * @param device_key	Pointer to a key known only to this device, that the cached keys are encrypted with.
+ * @param device_keylen	The size, in bytes, of the @b device_key.
+ * @returns A response code indicating the return status of this function.
+ */
+ec_error_t cryptx_ec_session_init(struct cryptx_ec_session_cache *cache,
+								  struct cryptx_ec_session *entries, size_t count,
+								  const void *device_key, size_t device_keylen);
+
+/**
+ * @brief Stores the session keys derived with a peer, replacing any it already had, and issues a ticket for them.
+ * @param cache	Pointer to a session cache.
+ * @param rpubkey	Pointer to the remote public key, in any format.
+ * @param rpubkey_len	Length of @b rpubkey.
+ * @param keys	Pointer to @b CRYPTX_KEYLEN_EC_SESSION bytes of keys derived from the secret. Never cache the secret itself.
+ * @param ticket	Pointer to a buffer to write a random @b CRYPTX_TICKETLEN_EC_SESSION byte ticket to.
+ * Send it to the peer over the session, for it to present when it reconnects.
+ * @returns A response code indicating the return status of this function.
+ * @note The keys are kept xored with HMAC-SHA256 of the device key, the peer and the ticket,
+ * so they cannot be read back out of @b entries without the ticket.
+ */
+ec_error_t cryptx_ec_session_store(struct cryptx_ec_session_cache *cache,
+								   const uint8_t *rpubkey, size_t rpubkey_len,
+								   const uint8_t *keys, uint8_t *ticket);
+
+/**
+ * @brief Looks up the session keys for a reconnecting peer, in place of a new key agreement.
+ * @param cache	Pointer to a session cache.
+ * @param rpubkey	Pointer to the remote public key, in the same format it was stored with.
+ * @param rpubkey_len	Length of @b rpubkey.
+ * @param keys	Pointer to a buffer to write the @b CRYPTX_KEYLEN_EC_SESSION bytes of keys to.
+ * @param ticket	Pointer to the ticket the peer presented.
+ * @returns @b true and the keys if the peer has a session and the ticket is the one issued for it,
+ * @b false otherwise. Fall back to @b cryptx_ec_secret on @b false.
+ * @note The ticket is compared in constant time.
+ */
+bool cryptx_ec_session_lookup(struct cryptx_ec_session_cache *cache,
+							  const uint8_t *rpubkey, size_t rpubkey_len,
+							  uint8_t *keys, const uint8_t *ticket);
+
+/**
+ * @brief Removes a peer's session from the cache.
+ * @param cache	Pointer to a session cache.
+ * @param rpubkey	Pointer to the remote public key, or NULL to remove every session.
+ * @param rpubkey_len	Length of @b rpubkey.
+ */
+void cryptx_ec_session_invalidate(struct cryptx_ec_session_cache *cache,
+								  const uint8_t *rpubkey, size_t rpubkey_len);
+
 /// ### ABSTRACT SYNTAX NOTATION ONE (ASN.1) ###
 
 enum cryptx_asn1_tags {
@@ -556,6 +1454,134 @@ asn1_error_t cryptx_asn1_decode(
 					uint8_t index,
 					struct cryptx_asn1_object *object);
 
+/// Defines the maximum number of nested levels a @b cryptx_asn1_cursor can enter.
+#define CRYPTX_ASN1_MAX_DEPTH	8
+
+/// Holds the position of a linear walk over ASN.1-encoded data.
+struct cryptx_asn1_cursor {
+	uint8_t *pos;		/**< Current parse position. */
+	uint8_t *end;		/**< End of the current tree level. */
+	uint8_t depth;		/**< Number of levels entered. */
+	uint8_t *ends[CRYPTX_ASN1_MAX_DEPTH];	/**< Ends of the enclosing tree levels. */
+};
+
+/**
+ * @brief Initializes a cursor at the first element of a block of ASN.1-encoded data.
+ * @param cursor	Pointer to a cursor to initialize.
+ * @param data		Pointer to a block of ASN.1-encoded data to parse.
+ * @param len		Length of ASN.1-encoded block to parse.
+ * @returns			An @b asn1_error_t indicating the status of the operation.
+ */
+asn1_error_t cryptx_asn1_cursor_init(struct cryptx_asn1_cursor *cursor, const void *data, size_t len);
+
+/**
+ * @brief Decodes the element at the cursor and advances the cursor past it.
+ * @param cursor	Pointer to a cursor.
+ * @param object	Pointer to an @b asn1_object to populate. May be NULL to skip an element.
+ * @returns			An @b asn1_error_t indicating the status of the operation.
+ *                  @b ASN1_END_OF_FILE is returned at the end of the current tree level.
+ */
+asn1_error_t cryptx_asn1_next(struct cryptx_asn1_cursor *cursor, struct cryptx_asn1_object *object);
+
+/**
+ * @brief Descends into the data of an object just returned by @b cryptx_asn1_next.
+ * @param cursor	Pointer to a cursor.
+ * @param object	Pointer to the object to enter.
+ * @returns			An @b asn1_error_t indicating the status of the operation.
+ *                  @b ASN1_INVALID_ARG is returned if @b CRYPTX_ASN1_MAX_DEPTH levels are already entered.
+ * @note The next call to @b cryptx_asn1_next returns the first element nested within @b object.
+ */
+asn1_error_t cryptx_asn1_enter(struct cryptx_asn1_cursor *cursor, const struct cryptx_asn1_object *object);
+
+/**
+ * @brief Returns to the enclosing tree level, positioned after the element that was entered.
+ * @param cursor	Pointer to a cursor.
+ * @returns			An @b asn1_error_t indicating the status of the operation.
+ *                  @b ASN1_INVALID_ARG is returned if the cursor is at the top level.
+ */
+asn1_error_t cryptx_asn1_leave(struct cryptx_asn1_cursor *cursor);
+
+/**
+ * @brief Locates an element by its path of indices from the top level in a single pass.
+ * @param data		Pointer to a block of ASN.1-encoded data to parse.
+ * @param len		Length of ASN.1-encoded block to parse.
+ * @param path		Array of element indices, one per tree level.
+ * @param depth		Number of indices in @b path.
+ * @param object	Pointer to an @b asn1_object to populate with the element found.
+ * @returns			An @b asn1_error_t indicating the status of the operation.
+ * @note Every element but the last one in the path is entered, e.g. {0, 2, 1} returns the
+ * second element of the third element of the first element of @b data.
+ */
+asn1_error_t cryptx_asn1_lookup(const void *data, size_t len,
+								const uint8_t *path, uint8_t depth,
+								struct cryptx_asn1_object *object);
+
+/// Returns an identifier octet for use with the ASN.1 writer, given a tag, class and form.
+#define cryptx_asn1_maketag(tag, class, form)	((tag) | ((class)<<6) | ((form)<<5))
+
+/// Holds the state of a DER encoding in progress.
+struct cryptx_asn1_writer {
+	uint8_t *buf;		/**< Output buffer, or NULL to only compute the encoded length. */
+	size_t size;		/**< Size of the output buffer. */
+	size_t len;			/**< Number of bytes encoded so far. */
+	uint8_t depth;		/**< Number of elements currently open. */
+	bool error;			/**< Set if any write failed. */
+	size_t open[CRYPTX_ASN1_MAX_DEPTH];	/**< Offsets of the length octets of the open elements. */
+};
+
+/**
+ * @brief Initializes a writer that DER-encodes into a caller buffer.
+ * @param writer	Pointer to a writer to initialize.
+ * @param buf		Pointer to the output buffer. May be NULL to only compute the encoded length.
+ * @param size		Size of the output buffer.
+ */
+void cryptx_asn1_writer_init(struct cryptx_asn1_writer *writer, void *buf, size_t size);
+
+/**
+ * @brief Opens a constructed element (or a BIT STRING / OCTET STRING wrapping other elements).
+ * @param writer	Pointer to a writer.
+ * @param tag		Identifier octet of the element. See @b cryptx_asn1_maketag.
+ * @returns			@b True if the writer is not in an error state.
+ * @note Elements written until the matching @b cryptx_asn1_writer_end become the content of this element.
+ * @note The unused-bits octet of a BIT STRING (0x03) is written automatically, but not for other tags numbered 3 such as context-specific [3].
+ */
+bool cryptx_asn1_writer_begin(struct cryptx_asn1_writer *writer, uint8_t tag);
+
+/**
+ * @brief Closes the element last opened by @b cryptx_asn1_writer_begin and fills in its length.
+ * @param writer	Pointer to a writer.
+ * @returns			@b True if the writer is not in an error state.
+ */
+bool cryptx_asn1_writer_end(struct cryptx_asn1_writer *writer);
+
+/**
+ * @brief Writes a complete primitive element.
+ * @param writer	Pointer to a writer.
+ * @param tag		Identifier octet of the element. See @b cryptx_asn1_maketag.
+ * @param data		Pointer to the content of the element.
+ * @param len		Length of the content.
+ * @returns			@b True if the writer is not in an error state.
+ * @note The unused-bits octet of a BIT STRING (0x03) is written automatically, but not for other tags numbered 3 such as context-specific [3].
+ */
+bool cryptx_asn1_writer_put(struct cryptx_asn1_writer *writer, uint8_t tag, const void *data, size_t len);
+
+/**
+ * @brief Writes an unsigned big-endian integer as an INTEGER element.
+ * @param writer	Pointer to a writer.
+ * @param data		Pointer to the big-endian integer.
+ * @param len		Length of the integer.
+ * @returns			@b True if the writer is not in an error state.
+ * @note Leading zero bytes are removed and a zero byte is prepended if needed to keep the value positive.
+ */
+bool cryptx_asn1_writer_put_integer(struct cryptx_asn1_writer *writer, const void *data, size_t len);
+
+/**
+ * @brief Completes an encoding.
+ * @param writer	Pointer to a writer.
+ * @returns			The length of the encoded data, or 0 if a write failed or an element is still open.
+ */
+size_t cryptx_asn1_writer_finish(const struct cryptx_asn1_writer *writer);
+
 
 /** Defines a macro to return the expected base64-encoded data length, given octet-encoded @b len. This should be len \* 8 / 6. */
 #define	cryptx_base64_get_encoded_len(len)		((len) * 4 / 3)
@@ -577,10 +1603,63 @@ size_t cryptx_base64_encode(void *dest, const void *src, size_t len);
  * @param dest Pointer to output octet-encoded data stream.
  * @param src Pointer to input sextet-encoded data stream.
  * @param len Length of sextet-encoded data stream.
- * @returns Length of output octet.
+ * @returns Length of output octet, or 0 if the input is not valid Base64.
+ * @note Whitespace such as PEM line breaks is skipped.
  */
 size_t cryptx_base64_decode(void *dest, const void *src, size_t len);
 
+/// Holds the state of a Base64 encoding or decoding done in parts.
+struct cryptx_base64_ctx {
+	uint8_t quantum[4];		/**< Octets (encoding) or sextets (decoding) not yet converted. */
+	uint8_t count;			/**< Number of entries in @b quantum. */
+	uint8_t padding;		/**< Number of padding characters decoded. */
+	bool error;				/**< Set if invalid input was decoded. */
+};
+
+/**
+ * @brief Initializes a context for encoding or decoding Base64 in parts.
+ * @param ctx Pointer to a context.
+ */
+void cryptx_base64_init(struct cryptx_base64_ctx *ctx);
+
+/**
+ * @brief Encodes a part of an octet-encoded data stream.
+ * @param ctx Pointer to a context.
+ * @param dest Pointer to output sextet-encoded data. Must hold @b cryptx_base64_get_encoded_len(len + 2) bytes.
+ * @param src Pointer to input octet-encoded data.
+ * @param len Length of input.
+ * @returns Length of output. Up to two octets are held in @b ctx until the next call.
+ */
+size_t cryptx_base64_encode_update(struct cryptx_base64_ctx *ctx, void *dest, const void *src, size_t len);
+
+/**
+ * @brief Encodes the octets held in the context, with padding.
+ * @param ctx Pointer to a context.
+ * @param dest Pointer to output sextet-encoded data. Must hold 4 bytes.
+ * @returns Length of output.
+ */
+size_t cryptx_base64_encode_final(struct cryptx_base64_ctx *ctx, void *dest);
+
+/**
+ * @brief Decodes a part of a sextet-encoded data stream.
+ * @param ctx Pointer to a context.
+ * @param dest Pointer to output octet-encoded data. Must hold @b cryptx_base64_get_decoded_len(len + 3) bytes.
+ * @param src Pointer to input sextet-encoded data.
+ * @param len Length of input.
+ * @returns Length of output. Up to three characters are held in @b ctx until the next call.
+ * @note Whitespace is skipped. On invalid input, decoding stops and @b ctx->error is set.
+ */
+size_t cryptx_base64_decode_update(struct cryptx_base64_ctx *ctx, void *dest, const void *src, size_t len);
+
+/**
+ * @brief Decodes the characters held in the context, for input that is not padded.
+ * @param ctx Pointer to a context.
+ * @param dest Pointer to output octet-encoded data. Must hold 2 bytes.
+ * @returns Length of output.
+ * @note Check @b ctx->error afterwards to find out if the input was valid.
+ */
+size_t cryptx_base64_decode_final(struct cryptx_base64_ctx *ctx, void *dest);
+
 
 /// ### PUBLIC KEY CRYPTOGRAPHY STANDARDS 8 (PKCS#8) ###
 /// Abstraction for importing of PKCS-encoded keyfiles compatible with TLS (and raw input).
@@ -663,28 +1742,60 @@ static const uint8_t cryptx_pkcs8_curveid_sect233k1[] = {0x2B,0x81,0x04,0x00,0x1
 
 /**
  * @brief Attempts to import a PKCS#8-encoded public key for RSA or ECC.
- * @param data Pointer to PKCS#8-encoded key data.
+ * @param data Pointer to PKCS#8-encoded key data, either PEM or raw DER.
  * @param len   Length of key data to import.
  * @param malloc     Pointer to toolchain @b malloc function.
  * @returns A malloc'd @b cryptx_pkcs8_pubkey structure populated with key metadata.
- * @returns NULL if arguments invalid or allocation failure.
+ * @returns NULL if arguments invalid, the encoded key runs past @b len, or allocation failure.
  * @returns The @b error field of the structure set to @b True if a deserialization error occurred.
+ * @note PEM data is decoded in place, overwriting it: on return @b data holds the DER encoding of
+ * the key rather than the PEM text. No other buffer is used, so PEM data not in RAM (such as an
+ * archived appvar) cannot be decoded and NULL is returned for it.
  */
 struct cryptx_pkcs8_pubkey *cryptx_pkcs8_import_publickey(void *data, size_t len,
                                                           void* (*malloc)(size_t));
 
 /**
  * @brief Attempts to import a PKCS#8-encoded private key for RSA or ECC.
- * @param data Pointer to PKCS#8-encoded key data.
+ * @param data Pointer to PKCS#8-encoded key data, either PEM or raw DER.
  * @param len   Length of key data to import.
  * @param malloc     Pointer to toolchain @b malloc function.
  * @returns A malloc'd @b cryptx_pkcs8_privkey structure populated with key metadata.
- * @returns NULL if arguments invalid or allocation failure.
+ * @returns NULL if arguments invalid, the encoded key runs past @b len, or allocation failure.
  * @returns The @b error field of the structure set to @b True if a deserialization error occurred.
+ * @note PEM data is decoded in place, overwriting it: on return @b data holds the DER encoding of
+ * the key rather than the PEM text. No other buffer is used, so PEM data not in RAM (such as an
+ * archived appvar) cannot be decoded and NULL is returned for it.
  */
 struct cryptx_pkcs8_privkey *cryptx_pkcs8_import_privatekey(void *data, size_t len,
                                                             void* (*malloc)(size_t));
 
+/**
+ * @brief Parses a DER-encoded PKCS#8 public key in place, without allocating or copying.
+ * @param data Pointer to DER-encoded key data. Must remain valid for as long as @b key is used.
+ * @param len   Length of key data.
+ * @param key   Pointer to a caller-provided structure to populate. Its @b len is set to 0.
+ * @returns @b key, with fields referencing @b data.
+ * @returns NULL if arguments invalid.
+ * @returns The @b error field of the structure set to @b True if a deserialization error occurred or @b data is not DER.
+ * @note A viewed key must not be passed to @b cryptx_pkcs8_free_publickey.
+ */
+struct cryptx_pkcs8_pubkey *cryptx_pkcs8_view_publickey(const void *data, size_t len,
+                                                        struct cryptx_pkcs8_pubkey *key);
+
+/**
+ * @brief Parses a DER-encoded PKCS#8 private key in place, without allocating or copying.
+ * @param data Pointer to DER-encoded key data. Must remain valid for as long as @b key is used.
+ * @param len   Length of key data.
+ * @param key   Pointer to a caller-provided structure to populate. Its @b len is set to 0.
+ * @returns @b key, with fields referencing @b data.
+ * @returns NULL if arguments invalid.
+ * @returns The @b error field of the structure set to @b True if a deserialization error occurred or @b data is not DER.
+ * @note A viewed key must not be passed to @b cryptx_pkcs8_free_privatekey.
+ */
+struct cryptx_pkcs8_privkey *cryptx_pkcs8_view_privatekey(const void *data, size_t len,
+                                                          struct cryptx_pkcs8_privkey *key);
+
 /**
  * @brief Erases a PKCS#8 public key structure returned by @b cryptx_pkcs8_import_publickey and then frees the allocated memory.
  * @param pk        Pointer to a PKCS#8 public key structure.
@@ -700,6 +1811,32 @@ void cryptx_pkcs8_free_publickey(struct cryptx_pkcs8_pubkey *pk, void (*free)(vo
 void cryptx_pkcs8_free_privatekey(struct cryptx_pkcs8_privkey *pk, void (*free)(void*));
 
 
+/// ### INSTRUMENTATION ###
+/// Counters kept by the instrumented build of the library (cryptx_stats.8xv). The regular build keeps none.
+
+/// Counters for one exported function.
+struct cryptx_stats {
+	const char *name;		/**< Name of the exported function. */
+	uint32_t calls;			/**< Number of calls. */
+	uint32_t cycles;		/**< Cumulative CPU cycles spent in the function, including nested exports. Wraps around. */
+	size_t stack_depth;		/**< Maximum stack depth reached, in bytes below the caller's stack pointer. */
+};
+
+/**
+ * @brief Returns the counters of an exported function.
+ * @param index	Index of the function, starting from 0.
+ * @param stats	Pointer to a structure to write the counters to.
+ * @returns @b True if @b index is valid and this is the instrumented build, @b False otherwise.
+ * @note Loop @b index from 0 until this returns @b False to read every function.
+ */
+bool cryptx_stats_get(uint8_t index, struct cryptx_stats *stats);
+
+/**
+ * @brief Clears all counters.
+ */
+void cryptx_stats_reset(void);
+
+
 #ifdef CRYPTX_ENABLE_HAZMAT
 
 /**
@@ -778,7 +1915,7 @@ void cryptx_hazmat_powmod(uint8_t size, uint8_t *restrict base, uint24_t exp, co
 struct cryptx_ecc_point {
 	uint8_t x[CRYPTX_GF2_INTLEN];
 	uint8_t y[CRYPTX_GF2_INTLEN];
-}
+};
 
 /**
  @brief Elliptic Curve Point Addition over SECT233k1
@@ -786,14 +1923,14 @@ struct cryptx_ecc_point {
  @param q	Pointer to second point to add.
  @note Outputs in @b p.
  */
-void cryptx_hazmat_ecc_point_add(cryptx_ecc_point* p, cryptx_ecc_point* q);
+void cryptx_hazmat_ecc_point_add(struct cryptx_ecc_point* p, struct cryptx_ecc_point* q);
 
 /**
  @brief Elliptic Curve Point Doubling over SECT233k1
  @param p	Pointer to point to double.
  @note Outputs in @b p.
  */
-void cryptx_hazmat_ecc_point_double(cryptx_ecc_point* p);
+void cryptx_hazmat_ecc_point_double(struct cryptx_ecc_point* p);
 
 /**
  @brief Elliptic Curve Scalar Multiplication over SECT233k1
@@ -802,7 +1939,7 @@ void cryptx_hazmat_ecc_point_double(cryptx_ecc_point* p);
  @param scalar_bit_width	Length, in bits, of the scalar.
  @note Outputs in @b p.
  */
-void cryptx_hazmat_ecc_point_mul_scalar(cryptx_ecc_point* p,
+void cryptx_hazmat_ecc_point_mul_scalar(struct cryptx_ecc_point* p,
 										  const uint8_t* scalar,
 										  size_t scalar_bit_width);
 
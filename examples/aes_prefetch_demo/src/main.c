@@ -0,0 +1,54 @@
+/*
+ *--------------------------------------
+ * Program Name:
+ * Author:
+ * License:
+ * Description:
+ *--------------------------------------
+*/
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdio.h>
+#include <cryptx.h>
+
+#define CEMU_CONSOLE ((char*)0xFB0000)
+#define KEYSIZE (256>>3)    // 256 bits converted to bytes
+#define RING_BLOCKS	8
+
+char *msg = "The lazy fox jumped over the dog, then the dog got angry and barked at it for a while.";
+uint8_t key[KEYSIZE] = {
+	0xEE,0x89,0x19,0xC3,0x8D,0x53,0x7A,0xD6,0x04,0x19,0x9E,0x77,0x0B,0xE0,0xE0,0x4C,0x4C,0x70,0xDB,0xE1,0x22,0x79,0xE1,0x90,0x06,0x1B,0xAF,0x99,0x49,0x8E,0x66,0x73
+};
+uint8_t iv[CRYPTX_BLOCKSIZE_AES] = {
+	0x79,0xA6,0xDE,0xDF,0xF0,0xA2,0x7C,0x7F,0xEE,0x0B,0x8E,0xF5,0x12,0x63,0xA4,0x8A
+};
+uint8_t ring[RING_BLOCKS * CRYPTX_BLOCKSIZE_AES];
+uint8_t expected[128], prefetched[128];
+
+int main(void)
+{
+	struct cryptx_aes_ctx ctx;
+	struct cryptx_aes_prefetch pf;
+	size_t len = strlen(msg);
+
+	// keystream computed inline
+	cryptx_aes_init(&ctx, key, KEYSIZE, iv, CRYPTX_BLOCKSIZE_AES, CRYPTX_AES_CTR, CRYPTX_AES_CTR_DEFAULTS);
+	cryptx_aes_encrypt(&ctx, msg, len, expected);
+
+	// keystream computed ahead, as a program would while waiting on the link
+	// the message is longer than the ring, so the last blocks are computed inline
+	cryptx_aes_init(&ctx, key, KEYSIZE, iv, CRYPTX_BLOCKSIZE_AES, CRYPTX_AES_CTR, CRYPTX_AES_CTR_DEFAULTS);
+	if(cryptx_aes_prefetch_attach(&ctx, &pf, ring, RING_BLOCKS) != AES_OK)
+		return 1;
+	while(cryptx_aes_prefetch_fill(&pf, 1) < 4);
+	sprintf(CEMU_CONSOLE, "blocks buffered: %u\n", cryptx_aes_prefetch_fill(&pf, 0));
+	cryptx_aes_encrypt(&ctx, msg, len, prefetched);
+	cryptx_aes_prefetch_detach(&pf);
+
+	sprintf(CEMU_CONSOLE, "aes-ctr with prefetch: %s\n",
+		cryptx_bytes_compare(expected, prefetched, len) ? "match" : "MISMATCH");
+	return 0;
+}
@@ -0,0 +1,81 @@
+/*
+ *--------------------------------------
+ * Program Name:
+ * Author:
+ * License:
+ * Description:
+ *--------------------------------------
+*/
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdio.h>
+#include <fileioc.h>
+#include <cryptx.h>
+
+#define CEMU_CONSOLE ((char*)0xFB0000)
+#define VAR_NAME	"CRXDEMO"
+#define VAR_LEN		1000
+#define KEYSIZE (256>>3)    // 256 bits converted to bytes
+
+uint8_t key[KEYSIZE] = {
+	0xEE,0x89,0x19,0xC3,0x8D,0x53,0x7A,0xD6,0x04,0x19,0x9E,0x77,0x0B,0xE0,0xE0,0x4C,0x4C,0x70,0xDB,0xE1,0x22,0x79,0xE1,0x90,0x06,0x1B,0xAF,0x99,0x49,0x8E,0x66,0x73
+};
+uint8_t iv[CRYPTX_BLOCKSIZE_AES] = {
+	0x79,0xA6,0xDE,0xDF,0xF0,0xA2,0x7C,0x7F,0xEE,0x0B,0x8E,0xF5,0x12,0x63,0xA4,0x8A
+};
+uint8_t data[VAR_LEN];
+uint8_t expected[VAR_LEN + CRYPTX_BLOCKSIZE_AES];
+uint8_t streamed[VAR_LEN + CRYPTX_BLOCKSIZE_AES];
+
+// collects each window of ciphertext into the buffer passed as user
+void collect(const void *window, size_t len, void *user){
+	size_t *offset = user;
+	memcpy(&streamed[*offset], window, len);
+	*offset += len;
+}
+
+int main(void)
+{
+	struct cryptx_hash_ctx h;
+	struct cryptx_aes_ctx aes;
+	uint8_t digest_ram[CRYPTX_DIGESTLEN_SHA256], digest_flash[CRYPTX_DIGESTLEN_SHA256];
+	uint8_t window[64];
+	size_t offset = 0;
+	size_t ctlen = cryptx_aes_get_ciphertext_len(VAR_LEN);
+	uint8_t var;
+
+	// write some data to an appvar and archive it
+	for(size_t i = 0; i < VAR_LEN; i++)
+		data[i] = (uint8_t)(i * 7);
+	if(!(var = ti_Open(VAR_NAME, "w")))
+		return 1;
+	ti_Write(data, VAR_LEN, 1, var);
+	ti_SetArchiveStatus(true, var);
+	ti_Close(var);
+
+	// hashing the archived appvar matches hashing the data
+	cryptx_hash_init(&h, SHA256);
+	cryptx_hash_update(&h, data, VAR_LEN);
+	cryptx_hash_digest(&h, digest_ram);
+	cryptx_hash_init(&h, SHA256);
+	if(!cryptx_hash_update_appvar(&h, VAR_NAME))
+		return 1;
+	cryptx_hash_digest(&h, digest_flash);
+	sprintf(CEMU_CONSOLE, "hash from flash: %s\n",
+		cryptx_bytes_compare(digest_ram, digest_flash, CRYPTX_DIGESTLEN_SHA256) ? "match" : "MISMATCH");
+
+	// so does encrypting it through a small window
+	cryptx_aes_init(&aes, key, KEYSIZE, iv, CRYPTX_BLOCKSIZE_AES, CRYPTX_AES_CBC, CRYPTX_AES_CBC_DEFAULTS);
+	cryptx_aes_encrypt(&aes, data, VAR_LEN, expected);
+	cryptx_aes_init(&aes, key, KEYSIZE, iv, CRYPTX_BLOCKSIZE_AES, CRYPTX_AES_CBC, CRYPTX_AES_CBC_DEFAULTS);
+	if(cryptx_aes_encrypt_appvar(&aes, VAR_NAME, window, sizeof window, collect, &offset) != AES_OK)
+		return 1;
+	sprintf(CEMU_CONSOLE, "aes-cbc from flash: %s\n",
+		(offset == ctlen && cryptx_bytes_compare(expected, streamed, ctlen)) ? "match" : "MISMATCH");
+
+	ti_Delete(VAR_NAME);
+	return 0;
+}
@@ -0,0 +1,86 @@
+/*
+ *--------------------------------------
+ * Program Name:
+ * Author:
+ * License:
+ * Description:
+ *--------------------------------------
+*/
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdio.h>
+#include <cryptx.h>
+
+#define CEMU_CONSOLE ((char*)0xFB0000)
+
+/*
+ SEQUENCE {
+   INTEGER 2
+   [3] EXPLICIT {			-- as X.509 wraps its extensions
+     SEQUENCE {
+       BIT STRING ABCD
+     }
+   }
+   [3] IMPLICIT "ab"
+   BIT STRING {
+     NULL
+   }
+ }
+ */
+const uint8_t expected[] = {
+	0x30, 0x15,
+	0x02, 0x01, 0x02,
+	0xA3, 0x07,
+	0x30, 0x05,
+	0x03, 0x03, 0x00, 0xAB, 0xCD,
+	0x83, 0x02, 'a', 'b',
+	0x03, 0x03, 0x00,
+	0x05, 0x00
+};
+const uint8_t version[] = {0x02};
+const uint8_t bits[] = {0xAB, 0xCD};
+
+struct cryptx_asn1_writer writer;
+uint8_t der[64];
+
+size_t encode(void *buf, size_t size){
+	cryptx_asn1_writer_init(&writer, buf, size);
+	cryptx_asn1_writer_begin(&writer, cryptx_asn1_maketag(ASN1_SEQUENCE, ASN1_UNIVERSAL, ASN1_CONSTRUCTED));
+	cryptx_asn1_writer_put_integer(&writer, version, sizeof version);
+	// tag number 3 in another class is not a BIT STRING, so no unused-bits octet
+	cryptx_asn1_writer_begin(&writer, cryptx_asn1_maketag(3, ASN1_CONTEXTSPEC, ASN1_CONSTRUCTED));
+	cryptx_asn1_writer_begin(&writer, cryptx_asn1_maketag(ASN1_SEQUENCE, ASN1_UNIVERSAL, ASN1_CONSTRUCTED));
+	cryptx_asn1_writer_put(&writer, ASN1_BITSTRING, bits, sizeof bits);
+	cryptx_asn1_writer_end(&writer);
+	cryptx_asn1_writer_end(&writer);
+	cryptx_asn1_writer_put(&writer, cryptx_asn1_maketag(3, ASN1_CONTEXTSPEC, ASN1_PRIMITIVE), "ab", 2);
+	cryptx_asn1_writer_begin(&writer, ASN1_BITSTRING);
+	cryptx_asn1_writer_put(&writer, ASN1_NULL, NULL, 0);
+	cryptx_asn1_writer_end(&writer);
+	cryptx_asn1_writer_end(&writer);
+	return cryptx_asn1_writer_finish(&writer);
+}
+
+int main(void)
+{
+	size_t len;
+
+	len = encode(NULL, 0);
+	sprintf(CEMU_CONSOLE, "size-only pass: %u bytes %s\n", len,
+			(len == sizeof expected) ? "(expected)" : "(error)");
+
+	len = encode(der, sizeof der);
+	sprintf(CEMU_CONSOLE, "encoded %u bytes, %s\n", len,
+			(len == sizeof expected && !memcmp(der, expected, len)) ? "matches" : "differs (error)");
+	for(size_t i = 0; i < len; i++)
+		sprintf(CEMU_CONSOLE, "%02X ", der[i]);
+	sprintf(CEMU_CONSOLE, "\n");
+
+	// the buffer is one byte short
+	len = encode(der, sizeof expected - 1);
+	sprintf(CEMU_CONSOLE, "short buffer: %s\n", len ? "encoded (error)" : "failed (expected)");
+	return 0;
+}
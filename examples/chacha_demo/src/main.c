@@ -0,0 +1,130 @@
+/*
+ *--------------------------------------
+ * Program Name:
+ * Author:
+ * License:
+ * Description:
+ *--------------------------------------
+*/
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdio.h>
+#include <sys/timers.h>
+#include <cryptx.h>
+
+#define CEMU_CONSOLE ((char*)0xFB0000)
+#define PAYLOAD_LEN	1024
+
+// RFC 8439, section 2.8.2
+char *msg = "Ladies and Gentlemen of the class of '99: If I could offer you only one tip for the future, sunscreen would be it.";
+uint8_t aad[] = {0x50,0x51,0x52,0x53,0xc0,0xc1,0xc2,0xc3,0xc4,0xc5,0xc6,0xc7};
+uint8_t key[CRYPTX_KEYLEN_CHACHA] = {
+	0x80,0x81,0x82,0x83,0x84,0x85,0x86,0x87,0x88,0x89,0x8a,0x8b,0x8c,0x8d,0x8e,0x8f,
+	0x90,0x91,0x92,0x93,0x94,0x95,0x96,0x97,0x98,0x99,0x9a,0x9b,0x9c,0x9d,0x9e,0x9f
+};
+uint8_t nonce[CRYPTX_NONCELEN_CHACHA] = {
+	0x07,0x00,0x00,0x00,0x40,0x41,0x42,0x43,0x44,0x45,0x46,0x47
+};
+uint8_t payload[PAYLOAD_LEN];
+struct cryptx_chacha_ctx chacha;
+struct cryptx_aes_ctx aes;
+
+void hexdump(uint8_t *addr, size_t len, char *label){
+    if(label) sprintf(CEMU_CONSOLE, "\n%s\n", label);
+    else sprintf(CEMU_CONSOLE, "\n");
+    for(size_t rem_len = len, ct=1; rem_len>0; rem_len--, addr++, ct++){
+        sprintf(CEMU_CONSOLE, "\\x%02X", *addr);
+        if(!(ct%CRYPTX_TAGLEN_CHACHA)) sprintf(CEMU_CONSOLE, "\n");
+    }
+    sprintf(CEMU_CONSOLE, "\n");
+}
+
+void demo_chacha(void){
+	
+	size_t ctlen = strlen(msg);
+	uint8_t *ebuf = malloc(ctlen);
+	uint8_t *dbuf = malloc(ctlen);
+	uint8_t tag[CRYPTX_TAGLEN_CHACHA];
+	chacha_error_t error;
+	
+	sprintf(CEMU_CONSOLE, "\n-----------------------------------\nChaCha20-Poly1305\n\n");
+	
+	error = cryptx_chacha_init(&chacha, key, sizeof key, nonce, sizeof nonce);
+	sprintf(CEMU_CONSOLE, "chacha init complete, exit code %u\n", error);
+	cryptx_chacha_update_aad(&chacha, aad, sizeof aad);
+	error = cryptx_chacha_encrypt(&chacha, msg, ctlen, ebuf);
+	sprintf(CEMU_CONSOLE, "chacha encryption done, exit code %u\n", error);
+	hexdump(ebuf, ctlen, "-- encrypted msg --");
+	error = cryptx_chacha_digest(&chacha, tag);
+	sprintf(CEMU_CONSOLE, "chacha digest return done, exit code %u\n", error);
+	hexdump(tag, sizeof tag, "-- digest of aad + ciphertext --");
+	sprintf(CEMU_CONSOLE, "expected: \\x1A\\xE1\\x0B\\x59\\x4F\\x09\\xE2\\x6A\\x7E\\x90\\x2E\\xCB\\xD0\\x60\\x06\\x91\n");
+	
+	// #######################################################
+	// to test an invalid ciphertext uncomment the line below
+	// ebuf[10] ^= 0xff;
+	
+	cryptx_chacha_init(&chacha, key, sizeof key, nonce, sizeof nonce);
+	if(!cryptx_chacha_verify(&chacha, aad, sizeof aad, ebuf, ctlen, tag)){
+		sprintf(CEMU_CONSOLE, "auth tag invalid. not decrypting.\n");
+		return;
+	}
+	else
+		sprintf(CEMU_CONSOLE, "auth tag valid. proceeding.\n");
+	
+	cryptx_chacha_update_aad(&chacha, aad, sizeof aad);
+	memset(dbuf, 0, ctlen);
+	error = cryptx_chacha_decrypt(&chacha, ebuf, ctlen, dbuf);
+	sprintf(CEMU_CONSOLE, "chacha decryption done, exit code %u\n", error);
+	sprintf(CEMU_CONSOLE, "%.*s\n", (int)ctlen, dbuf);
+	free(ebuf);
+	free(dbuf);
+}
+
+// cycles to encrypt and authenticate PAYLOAD_LEN bytes, measured with timer 1 at CPU speed
+uint32_t bench_gcm(void){
+	uint8_t tag[CRYPTX_BLOCKSIZE_AES];
+	timer_Set(1, 0);
+	timer_Enable(1, TIMER_CPU, TIMER_NOINT, TIMER_UP);
+	cryptx_aes_init(&aes, key, sizeof key, nonce, sizeof nonce, CRYPTX_AES_GCM, CRYPTX_AES_GCM_DEFAULTS);
+	cryptx_aes_update_aad(&aes, aad, sizeof aad);
+	cryptx_aes_encrypt(&aes, payload, sizeof payload, payload);
+	cryptx_aes_digest(&aes, tag);
+	timer_Disable(1);
+	return timer_Get(1);
+}
+
+uint32_t bench_chacha(void){
+	uint8_t tag[CRYPTX_TAGLEN_CHACHA];
+	timer_Set(1, 0);
+	timer_Enable(1, TIMER_CPU, TIMER_NOINT, TIMER_UP);
+	cryptx_chacha_init(&chacha, key, sizeof key, nonce, sizeof nonce);
+	cryptx_chacha_update_aad(&chacha, aad, sizeof aad);
+	cryptx_chacha_encrypt(&chacha, payload, sizeof payload, payload);
+	cryptx_chacha_digest(&chacha, tag);
+	timer_Disable(1);
+	return timer_Get(1);
+}
+
+void demo_throughput(void){
+	uint32_t gcm, chacha;
+	
+	sprintf(CEMU_CONSOLE, "\n-----------------------------------\nThroughput, %u byte payload\n\n", PAYLOAD_LEN);
+	memset(payload, 0xA5, sizeof payload);
+	gcm = bench_gcm();
+	memset(payload, 0xA5, sizeof payload);
+	chacha = bench_chacha();
+	sprintf(CEMU_CONSOLE, "aes-256-gcm:       %lu cycles, %lu cycles/byte\n", gcm, gcm / PAYLOAD_LEN);
+	sprintf(CEMU_CONSOLE, "chacha20-poly1305: %lu cycles, %lu cycles/byte\n", chacha, chacha / PAYLOAD_LEN);
+}
+
+int main(void)
+{
+    sprintf(CEMU_CONSOLE, "\n------------------------------\nCryptX ChaCha20-Poly1305 Demo\n------------------------------\n");
+    
+	demo_chacha();
+	demo_throughput();
+}
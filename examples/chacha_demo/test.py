@@ -0,0 +1,13 @@
+
+from Cryptodome.Cipher import ChaCha20_Poly1305
+
+# RFC 8439, section 2.8.2 - matches the values used by the demo
+key = bytes(range(0x80, 0xa0))
+nonce = b"\x07\x00\x00\x00\x40\x41\x42\x43\x44\x45\x46\x47"
+aad = b"\x50\x51\x52\x53\xc0\xc1\xc2\xc3\xc4\xc5\xc6\xc7"
+pt = b"Ladies and Gentlemen of the class of '99: If I could offer you only one tip for the future, sunscreen would be it."
+
+cipher_encrypt = ChaCha20_Poly1305.new(key=key, nonce=nonce)
+cipher_encrypt.update(aad)
+ct, tag = cipher_encrypt.encrypt_and_digest(pt)
+print(f"chacha20-poly1305 encryption\n{ct.hex()}\ntag:\n{tag.hex()}\n")
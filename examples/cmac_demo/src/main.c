@@ -0,0 +1,74 @@
+/*
+ *--------------------------------------
+ * Program Name:
+ * Author:
+ * License:
+ * Description:
+ *--------------------------------------
+*/
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdio.h>
+#include <cryptx.h>
+
+#define CEMU_CONSOLE ((char*)0xFB0000)
+
+// RFC 4493 test vectors: AES-128 key 2b7e1516..., and the first 0, 16, 40 and 64 bytes of the message
+const uint8_t key[CRYPTX_KEYLEN_AES128] = {
+	0x2b,0x7e,0x15,0x16,0x28,0xae,0xd2,0xa6,0xab,0xf7,0x15,0x88,0x09,0xcf,0x4f,0x3c
+};
+const uint8_t msg[64] = {
+	0x6b,0xc1,0xbe,0xe2,0x2e,0x40,0x9f,0x96,0xe9,0x3d,0x7e,0x11,0x73,0x93,0x17,0x2a,
+	0xae,0x2d,0x8a,0x57,0x1e,0x03,0xac,0x9c,0x9e,0xb7,0x6f,0xac,0x45,0xaf,0x8e,0x51,
+	0x30,0xc8,0x1c,0x46,0xa3,0x5c,0xe4,0x11,0xe5,0xfb,0xc1,0x19,0x1a,0x0a,0x52,0xef,
+	0xf6,0x9f,0x24,0x45,0xdf,0x4f,0x9b,0x17,0xad,0x2b,0x41,0x7b,0xe6,0x6c,0x37,0x10
+};
+const size_t lengths[4] = {0, 16, 40, 64};
+const uint8_t expected[4][CRYPTX_BLOCKSIZE_AES] = {
+	{0xbb,0x1d,0x69,0x29,0xe9,0x59,0x37,0x28,0x7f,0xa3,0x7d,0x12,0x9b,0x75,0x67,0x46},
+	{0x07,0x0a,0x16,0xb4,0x6b,0x4d,0x41,0x44,0xf7,0x9b,0xdd,0x9d,0xd0,0x4a,0x28,0x7c},
+	{0xdf,0xa6,0x67,0x47,0xde,0x9a,0xe6,0x30,0x30,0xca,0x32,0x61,0x14,0x97,0xc8,0x27},
+	{0x51,0xf0,0xbe,0xbf,0x7e,0x3b,0x9d,0x92,0xfc,0x49,0x74,0x17,0x79,0x36,0x3c,0xfe}
+};
+// 32 bytes from the counter mode KDF with the same key, label "CMAC KDF demo" and context "session 1"
+const uint8_t expected_kdf[32] = {
+	0x26,0x8f,0x8c,0x36,0x08,0x9a,0x6e,0xab,0x81,0x4a,0x63,0xa0,0xa5,0x23,0x6a,0x3a,
+	0xd9,0x3d,0xb1,0x44,0x3f,0xbf,0xbb,0xa7,0x8a,0xa1,0x40,0x34,0x08,0xce,0xe4,0xe9
+};
+
+int main(void)
+{
+	struct cryptx_aes_ctx aes;
+	struct cryptx_aes_cmac_ctx cmac;
+	uint8_t iv[CRYPTX_BLOCKSIZE_AES] = {0};
+	uint8_t tag[CRYPTX_BLOCKSIZE_AES], tag2[CRYPTX_BLOCKSIZE_AES];
+	uint8_t derived[sizeof expected_kdf];
+	char hex[CRYPTX_BLOCKSIZE_AES * 2 + 1];
+
+	// CMAC only uses the key schedule, so the mode and iv don't matter
+	if(cryptx_aes_init(&aes, key, sizeof key, iv, sizeof iv, CRYPTX_AES_CBC, CRYPTX_AES_CBC_DEFAULTS) != AES_OK)
+		return 1;
+
+	for(uint8_t i = 0; i < 4; i++){
+		cryptx_aes_cmac(&aes, msg, lengths[i], tag);
+		cryptx_bytes_tostring(tag, sizeof tag, hex);
+		sprintf(CEMU_CONSOLE, "AES-CMAC, %u bytes: %s %s\n", lengths[i], hex,
+			memcmp(tag, expected[i], sizeof tag) ? "FAIL" : "ok");
+	}
+
+	// incremental, in uneven pieces, gives the same tag
+	cryptx_aes_cmac_init(&cmac, &aes);
+	cryptx_aes_cmac_update(&cmac, msg, 5);
+	cryptx_aes_cmac_update(&cmac, &msg[5], 27);
+	cryptx_aes_cmac_update(&cmac, &msg[32], 32);
+	cryptx_aes_cmac_digest(&cmac, tag2);
+	sprintf(CEMU_CONSOLE, "incremental: %s\n", memcmp(tag2, expected[3], sizeof tag2) ? "FAIL" : "ok");
+
+	cryptx_aes_cmac_kdf(&aes, "CMAC KDF demo", 13, "session 1", 9, derived, sizeof derived);
+	sprintf(CEMU_CONSOLE, "KDF: %s\n", memcmp(derived, expected_kdf, sizeof derived) ? "FAIL" : "ok");
+
+	return 0;
+}
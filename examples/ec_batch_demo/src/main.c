@@ -0,0 +1,72 @@
+/*
+ *--------------------------------------
+ * Program Name:
+ * Author:
+ * License:
+ * Description:
+ *--------------------------------------
+*/
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdio.h>
+#include <sys/timers.h>
+#include <cryptx.h>
+
+#define CEMU_CONSOLE ((char*)0xFB0000)
+#define PEERS 6
+
+uint8_t privkey[CRYPTX_KEYLEN_EC_PRIVKEY];
+uint8_t pubkey[CRYPTX_KEYLEN_EC_PUBKEY];
+uint8_t peer_privkeys[PEERS][CRYPTX_KEYLEN_EC_PRIVKEY];
+uint8_t peer_pubkeys[PEERS][CRYPTX_KEYLEN_EC_PUBKEY];
+uint8_t secrets[PEERS][CRYPTX_KEYLEN_EC_SECRET];
+uint8_t secret[CRYPTX_KEYLEN_EC_SECRET];
+
+// cycles between the two calls, measured with timer 1 at CPU speed
+void bench_start(void){
+	timer_Set(1, 0);
+	timer_Enable(1, TIMER_CPU, TIMER_NOINT, TIMER_UP);
+}
+
+uint32_t bench_stop(void){
+	timer_Disable(1);
+	return timer_Get(1);
+}
+
+int main(void)
+{
+	ec_error_t error;
+	uint32_t batch, single = 0;
+	uint8_t i, matches = 0;
+	
+	sprintf(CEMU_CONSOLE, "\n------------------------------\nCryptX Batch ECDH Demo\n------------------------------\n");
+	
+	cryptx_ec_keygen(privkey, pubkey);
+	for(i = 0; i < PEERS; i++)
+		cryptx_ec_keygen(peer_privkeys[i], peer_pubkeys[i]);
+	
+	bench_start();
+	error = cryptx_ec_secret_batch(privkey, peer_pubkeys[0], secrets[0], PEERS);
+	batch = bench_stop();
+	sprintf(CEMU_CONSOLE, "batch of %u complete, exit code %u\n", PEERS, error);
+	
+	// each peer derives the same secret from its side
+	for(i = 0; i < PEERS; i++){
+		bench_start();
+		cryptx_ec_secret(peer_privkeys[i], pubkey, secret);
+		single += bench_stop();
+		if(!memcmp(secret, secrets[i], sizeof secret)) matches++;
+	}
+	sprintf(CEMU_CONSOLE, "%u of %u secrets match\n", matches, PEERS);
+	sprintf(CEMU_CONSOLE, "batch: %lu cycles, one at a time: %lu cycles\n", batch, single);
+	
+	// a key that is not on the curve only spoils its own secret
+	peer_pubkeys[2][0] ^= 1;
+	error = cryptx_ec_secret_batch(privkey, peer_pubkeys[0], secrets[0], PEERS);
+	sprintf(CEMU_CONSOLE, "with one bad key, exit code %u\n", error);
+	
+	return 0;
+}
@@ -0,0 +1,71 @@
+/*
+ *--------------------------------------
+ * Program Name:
+ * Author:
+ * License:
+ * Description:
+ *--------------------------------------
+*/
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdio.h>
+#include <cryptx.h>
+
+#define CEMU_CONSOLE ((char*)0xFB0000)
+
+uint8_t privkey1[CRYPTX_KEYLEN_EC_PRIVKEY], privkey2[CRYPTX_KEYLEN_EC_PRIVKEY];
+uint8_t pubkey1[CRYPTX_KEYLEN_EC_PUBKEY], pubkey2[CRYPTX_KEYLEN_EC_PUBKEY];
+uint8_t cpubkey1[CRYPTX_KEYLEN_EC_CPUBKEY], cpubkey2[CRYPTX_KEYLEN_EC_CPUBKEY];
+uint8_t secret1[CRYPTX_KEYLEN_EC_SECRET], secret2[CRYPTX_KEYLEN_EC_SECRET];
+uint8_t pubkey[CRYPTX_KEYLEN_EC_PUBKEY];
+
+void hexdump(uint8_t *addr, size_t len, char *label){
+    if(label) sprintf(CEMU_CONSOLE, "\n%s\n", label);
+    else sprintf(CEMU_CONSOLE, "\n");
+    for(size_t rem_len = len, ct=1; rem_len>0; rem_len--, addr++, ct++){
+        sprintf(CEMU_CONSOLE, "%02X ", *addr);
+        if(!(ct%16)) sprintf(CEMU_CONSOLE, "\n");
+    }
+    sprintf(CEMU_CONSOLE, "\n");
+}
+
+int main(void)
+{
+	ec_error_t error;
+	
+	sprintf(CEMU_CONSOLE, "\n------------------------------\nCryptX EC Compressed Keys Demo\n------------------------------\n");
+	
+	cryptx_ec_keygen(privkey1, pubkey1);
+	cryptx_ec_keygen(privkey2, pubkey2);
+	
+	error = cryptx_ec_compress(pubkey1, cpubkey1);
+	sprintf(CEMU_CONSOLE, "compress complete, exit code %u\n", error);
+	hexdump(cpubkey1, sizeof cpubkey1, "---compressed public key 1---");
+	cryptx_ec_compress(pubkey2, cpubkey2);
+	
+	error = cryptx_ec_decompress(cpubkey1, pubkey);
+	sprintf(CEMU_CONSOLE, "decompress complete, exit code %u, %s\n", error,
+			memcmp(pubkey, pubkey1, sizeof pubkey) ? "mismatch" : "matches public key 1");
+	
+	// each side only ever sees the other's compressed key
+	error = cryptx_ec_secret_compressed(privkey1, cpubkey2, secret1);
+	sprintf(CEMU_CONSOLE, "secret 1 complete, exit code %u\n", error);
+	error = cryptx_ec_secret_compressed(privkey2, cpubkey1, secret2);
+	sprintf(CEMU_CONSOLE, "secret 2 complete, exit code %u\n", error);
+	sprintf(CEMU_CONSOLE, "secrets %s\n",
+			memcmp(secret1, secret2, sizeof secret1) ? "differ" : "match");
+	
+	// an x coordinate with no point on the curve is rejected
+	memset(cpubkey2, 0, sizeof cpubkey2);
+	cpubkey2[0] = 1;
+	do {
+		cpubkey2[0]++;
+		error = cryptx_ec_decompress(cpubkey2, pubkey);
+	} while(error == EC_OK);
+	sprintf(CEMU_CONSOLE, "x = %u has no point, exit code %u\n", cpubkey2[0], error);
+	
+	return 0;
+}
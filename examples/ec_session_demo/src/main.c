@@ -0,0 +1,110 @@
+/*
+ *--------------------------------------
+ * Program Name:
+ * Author:
+ * License:
+ * Description:
+ *--------------------------------------
+*/
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdio.h>
+#include <sys/timers.h>
+#include <cryptx.h>
+
+#define CEMU_CONSOLE ((char*)0xFB0000)
+#define PEERS 3
+#define CACHED 2
+
+uint8_t privkey[CRYPTX_KEYLEN_EC_PRIVKEY];
+uint8_t pubkey[CRYPTX_KEYLEN_EC_PUBKEY];
+uint8_t peer_privkeys[PEERS][CRYPTX_KEYLEN_EC_PRIVKEY];
+uint8_t peer_pubkeys[PEERS][CRYPTX_KEYLEN_EC_PUBKEY];
+uint8_t peer_keys[PEERS][CRYPTX_KEYLEN_EC_SESSION];
+uint8_t tickets[PEERS][CRYPTX_TICKETLEN_EC_SESSION];
+uint8_t secret[CRYPTX_KEYLEN_EC_SECRET];
+uint8_t keys[CRYPTX_KEYLEN_EC_SESSION];
+uint8_t device_key[32];
+
+struct cryptx_ec_session entries[CACHED];
+struct cryptx_ec_session_cache cache;
+
+// cycles between the two calls, measured with timer 1 at CPU speed
+void bench_start(void){
+	timer_Set(1, 0);
+	timer_Enable(1, TIMER_CPU, TIMER_NOINT, TIMER_UP);
+}
+
+uint32_t bench_stop(void){
+	timer_Disable(1);
+	return timer_Get(1);
+}
+
+// the session keys are a hash of the secret, never the secret itself
+void derive_keys(const uint8_t *secret, uint8_t *out){
+	struct cryptx_hash_ctx hash;
+	cryptx_hash_init(&hash, SHA256);
+	cryptx_hash_update(&hash, secret, CRYPTX_KEYLEN_EC_SECRET);
+	cryptx_hash_digest(&hash, out);
+}
+
+bool resume(uint8_t i){
+	return cryptx_ec_session_lookup(&cache, peer_pubkeys[i], CRYPTX_KEYLEN_EC_PUBKEY, keys, tickets[i]) &&
+		!memcmp(keys, peer_keys[i], sizeof keys);
+}
+
+int main(void)
+{
+	uint32_t full, resumed;
+	bool ok = true;
+	uint8_t i;
+	
+	sprintf(CEMU_CONSOLE, "\n------------------------------\nCryptX ECDH Session Cache Demo\n------------------------------\n");
+	
+	cryptx_ec_keygen(privkey, pubkey);
+	for(i = 0; i < PEERS; i++)
+		cryptx_ec_keygen(peer_privkeys[i], peer_pubkeys[i]);
+	cryptx_csrand_fill(device_key, sizeof device_key);
+	cryptx_ec_session_init(&cache, entries, CACHED, device_key, sizeof device_key);
+	
+	// first contact with peers 0 and 1: a full key agreement, then the keys are cached
+	for(i = 0; i < 2; i++){
+		bench_start();
+		cryptx_ec_secret(privkey, peer_pubkeys[i], secret);
+		derive_keys(secret, peer_keys[i]);
+		cryptx_ec_session_store(&cache, peer_pubkeys[i], CRYPTX_KEYLEN_EC_PUBKEY, peer_keys[i], tickets[i]);
+		full = bench_stop();
+	}
+	
+	// peer 0 reconnects with its ticket
+	bench_start();
+	if(!resume(0)) ok = false;
+	resumed = bench_stop();
+	sprintf(CEMU_CONSOLE, "key agreement: %lu cycles, resumed: %lu cycles\n", full, resumed);
+	
+	// a wrong ticket gets nothing
+	tickets[0][0] ^= 1;
+	if(resume(0)) ok = false;
+	tickets[0][0] ^= 1;
+	
+	// peer 2 fills the cache, evicting peer 1, the least recently used
+	cryptx_ec_secret(privkey, peer_pubkeys[2], secret);
+	derive_keys(secret, peer_keys[2]);
+	cryptx_ec_session_store(&cache, peer_pubkeys[2], CRYPTX_KEYLEN_EC_PUBKEY, peer_keys[2], tickets[2]);
+	if(resume(1) || !resume(0) || !resume(2)) ok = false;
+	
+	// and an invalidated peer must agree on a key again
+	cryptx_ec_session_invalidate(&cache, peer_pubkeys[0], CRYPTX_KEYLEN_EC_PUBKEY);
+	if(resume(0) || !resume(2)) ok = false;
+	
+	// the peer's side of the first key agreement gives the same keys
+	cryptx_ec_secret(peer_privkeys[2], pubkey, secret);
+	derive_keys(secret, keys);
+	if(memcmp(keys, peer_keys[2], sizeof keys)) ok = false;
+	
+	sprintf(CEMU_CONSOLE, "store/lookup/evict/invalidate: %s\n", ok ? "ok" : "FAIL");
+	return 0;
+}
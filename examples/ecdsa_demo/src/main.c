@@ -0,0 +1,114 @@
+/*
+ *--------------------------------------
+ * Program Name:
+ * Author:
+ * License:
+ * Description:
+ *--------------------------------------
+*/
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdio.h>
+#include <sys/timers.h>
+#include <cryptx.h>
+
+#define CEMU_CONSOLE ((char*)0xFB0000)
+
+char *msg = "The fastest way to verify two scalar multiplications is to do one.";
+uint8_t privkey[CRYPTX_KEYLEN_EC_PRIVKEY];
+uint8_t pubkey[CRYPTX_KEYLEN_EC_PUBKEY];
+uint8_t signature[CRYPTX_SIGLEN_ECDSA];
+uint8_t digest[CRYPTX_DIGESTLEN_SHA256];
+struct cryptx_hash_ctx hash;
+
+// RFC 6979, A.2.9: K-233 with SHA-256 over "sample", keys little-endian as this library stores them
+const uint8_t vector_privkey[CRYPTX_KEYLEN_EC_PRIVKEY] = {
+	0xB0, 0xE9, 0x1B, 0x1D, 0x17, 0xA7, 0x5C, 0x9F, 0x39, 0xA2, 0x6D, 0x33, 0x79, 0x8F, 0x80,
+	0xF1, 0x9D, 0xD0, 0x80, 0x50, 0xB5, 0xC3, 0xA3, 0xC2, 0xBD, 0x42, 0x21, 0x3B, 0x10, 0x00
+};
+const uint8_t vector_pubkey[CRYPTX_KEYLEN_EC_PUBKEY] = {
+	0xF2, 0x79, 0x57, 0x59, 0x36, 0x47, 0x1C, 0x7E, 0x90, 0xBA, 0x58, 0x34, 0xE1, 0x9B, 0x2B,
+	0xB1, 0xC2, 0x20, 0x17, 0x22, 0x1A, 0x3C, 0x47, 0x68, 0x6C, 0xF3, 0x86, 0x28, 0x68, 0x00,
+	0x09, 0x03, 0xA1, 0x13, 0xEC, 0x44, 0x60, 0x54, 0x39, 0x3A, 0x50, 0x20, 0x8D, 0x92, 0xB3,
+	0xA3, 0x17, 0x78, 0x9B, 0x99, 0x90, 0x70, 0x92, 0xE0, 0x1B, 0xB4, 0x39, 0x06, 0xB2, 0x01
+};
+const uint8_t vector_signature[CRYPTX_SIGLEN_ECDSA] = {
+	0x38, 0xAD, 0x9C, 0x1D, 0x2C, 0xB2, 0x99, 0x06, 0xE7, 0xD6, 0x3C, 0x24, 0x60, 0x1A, 0xC5,
+	0x57, 0x36, 0xB4, 0x38, 0xFB, 0x14, 0xF4, 0x09, 0x3D, 0x6C, 0x32, 0xF6, 0x3A, 0x10, 0x64,
+	0x7A, 0xAD, 0x25, 0x99, 0xC2, 0x1B, 0x6E, 0xE8, 0x9B, 0xE7, 0xFF, 0x95, 0x7D, 0x98, 0xF6,
+	0x84, 0xB7, 0x92, 0x1D, 0xE1, 0xFD, 0x3C, 0xC8, 0x2C, 0x07, 0x96, 0x24, 0xF4
+};
+
+void hexdump(uint8_t *addr, size_t len, char *label){
+    if(label) sprintf(CEMU_CONSOLE, "\n%s\n", label);
+    else sprintf(CEMU_CONSOLE, "\n");
+    for(size_t rem_len = len, ct=1; rem_len>0; rem_len--, addr++, ct++){
+        sprintf(CEMU_CONSOLE, "%02X ", *addr);
+        if(!(ct%16)) sprintf(CEMU_CONSOLE, "\n");
+    }
+    sprintf(CEMU_CONSOLE, "\n");
+}
+
+// cycles between the two calls, measured with timer 1 at CPU speed
+void bench_start(void){
+	timer_Set(1, 0);
+	timer_Enable(1, TIMER_CPU, TIMER_NOINT, TIMER_UP);
+}
+
+uint32_t bench_stop(void){
+	timer_Disable(1);
+	return timer_Get(1);
+}
+
+int main(void)
+{
+	ec_error_t error;
+	uint8_t secret[CRYPTX_KEYLEN_EC_SECRET];
+	uint32_t sign, verify, ecdh;
+	bool valid;
+	
+	sprintf(CEMU_CONSOLE, "\n------------------------------\nCryptX ECDSA Demo\n------------------------------\n");
+	
+	error = cryptx_ec_keygen(privkey, pubkey);
+	sprintf(CEMU_CONSOLE, "keygen complete, exit code %u\n", error);
+	
+	cryptx_hash_init(&hash, SHA256);
+	cryptx_hash_update(&hash, msg, strlen(msg));
+	cryptx_hash_digest(&hash, digest);
+	
+	bench_start();
+	error = cryptx_ecdsa_sign(privkey, digest, sizeof digest, signature);
+	sign = bench_stop();
+	sprintf(CEMU_CONSOLE, "sign complete, exit code %u\n", error);
+	hexdump(signature, sizeof signature, "-- signature, r || s --");
+	
+	bench_start();
+	valid = cryptx_ecdsa_verify(pubkey, digest, sizeof digest, signature);
+	verify = bench_stop();
+	sprintf(CEMU_CONSOLE, "signature %s\n", valid ? "valid" : "invalid");
+	
+	// a changed digest must not verify
+	digest[0] ^= 1;
+	valid = cryptx_ecdsa_verify(pubkey, digest, sizeof digest, signature);
+	sprintf(CEMU_CONSOLE, "tampered digest %s\n", valid ? "valid (error)" : "invalid (expected)");
+	
+	// nonces are deterministic, so a known key and message give a known signature
+	cryptx_hash_init(&hash, SHA256);
+	cryptx_hash_update(&hash, "sample", 6);
+	cryptx_hash_digest(&hash, digest);
+	error = cryptx_ecdsa_sign(vector_privkey, digest, sizeof digest, signature);
+	sprintf(CEMU_CONSOLE, "\nRFC 6979 vector signed, exit code %u\n", error);
+	sprintf(CEMU_CONSOLE, "signature %s\n",
+			memcmp(signature, vector_signature, sizeof signature) ? "differs (error)" : "matches");
+	valid = cryptx_ecdsa_verify(vector_pubkey, digest, sizeof digest, signature);
+	sprintf(CEMU_CONSOLE, "signature %s\n", valid ? "valid" : "invalid (error)");
+	
+	bench_start();
+	cryptx_ec_secret(privkey, pubkey, secret);
+	ecdh = bench_stop();
+	sprintf(CEMU_CONSOLE, "\nsign:   %lu cycles\nverify: %lu cycles\necdh:   %lu cycles\n", sign, verify, ecdh);
+	return 0;
+}
@@ -0,0 +1,70 @@
+/*
+ *--------------------------------------
+ * Program Name:
+ * Author:
+ * License:
+ * Description:
+ *--------------------------------------
+*/
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdio.h>
+#include <cryptx.h>
+
+#define CEMU_CONSOLE ((char*)0xFB0000)
+
+// key 00 01 02 ..., mac key 20 21 22 ..., iv f0 f1 f2 ...
+// the tag is HMAC-SHA256(mac key, iv || aad || ciphertext || 48 as 8 bytes big-endian)
+const char header[] = "header";
+const char msg[] = "The fox jumped over the dog!";
+const uint8_t expected_tag[CRYPTX_DIGESTLEN_SHA256] = {
+	0x61,0xd7,0x6b,0xea,0x19,0xf0,0xe4,0xfa,0xa2,0xf5,0xe4,0xa9,0xdf,0x31,0xfd,0x53,
+	0xae,0xb5,0x34,0xe7,0x6d,0x9a,0x17,0xcd,0x18,0xba,0xff,0x7c,0xf7,0x55,0x7f,0xf8
+};
+
+uint8_t key[CRYPTX_KEYLEN_AES128], mac_key[32], iv[CRYPTX_BLOCKSIZE_AES];
+struct cryptx_aes_etm_ctx etm;
+
+bool seal_open(uint8_t mode, uint24_t flags, bool check_tag){
+	uint8_t buf[cryptx_aes_get_ciphertext_len(sizeof msg - 1)];
+	uint8_t tag[CRYPTX_DIGESTLEN_SHA256];
+	size_t msg_len = sizeof msg - 1;
+	size_t ct_len = (mode == CRYPTX_AES_CBC) ? cryptx_aes_get_ciphertext_len(msg_len) : msg_len;
+	bool ok = true;
+
+	// sender
+	cryptx_aes_etm_init(&etm, key, sizeof key, mac_key, sizeof mac_key, iv, sizeof iv, mode, flags);
+	cryptx_aes_etm_update_aad(&etm, header, sizeof header - 1);
+	cryptx_aes_etm_encrypt(&etm, msg, msg_len, buf);
+	cryptx_aes_etm_digest(&etm, tag);
+	if(check_tag) ok = !memcmp(tag, expected_tag, sizeof tag);
+
+	// receiver, checks the tag before decrypting in place
+	cryptx_aes_etm_init(&etm, key, sizeof key, mac_key, sizeof mac_key, iv, sizeof iv, mode, flags);
+	if(!cryptx_aes_etm_verify(&etm, header, sizeof header - 1, buf, ct_len, tag)) return false;
+	cryptx_aes_etm_update_aad(&etm, header, sizeof header - 1);
+	cryptx_aes_etm_decrypt(&etm, buf, ct_len, buf);
+	if(memcmp(buf, msg, msg_len)) return false;
+
+	// a single flipped bit in the ciphertext is caught
+	buf[0] ^= 1;
+	cryptx_aes_etm_init(&etm, key, sizeof key, mac_key, sizeof mac_key, iv, sizeof iv, mode, flags);
+	if(cryptx_aes_etm_verify(&etm, header, sizeof header - 1, buf, ct_len, tag)) return false;
+	return ok;
+}
+
+int main(void)
+{
+	for(uint8_t i = 0; i < sizeof key; i++) key[i] = i;
+	for(uint8_t i = 0; i < sizeof mac_key; i++) mac_key[i] = 0x20 + i;
+	for(uint8_t i = 0; i < sizeof iv; i++) iv[i] = 0xf0 + i;
+
+	sprintf(CEMU_CONSOLE, "AES-CBC + HMAC-SHA256: %s\n",
+		seal_open(CRYPTX_AES_CBC, CRYPTX_AES_CBC_DEFAULTS, true) ? "ok" : "FAIL");
+	sprintf(CEMU_CONSOLE, "AES-CTR + HMAC-SHA256: %s\n",
+		seal_open(CRYPTX_AES_CTR, CRYPTX_AES_CTR_DEFAULTS, false) ? "ok" : "FAIL");
+	return 0;
+}
@@ -0,0 +1,63 @@
+/*
+ *--------------------------------------
+ * Program Name:
+ * Author:
+ * License:
+ * Description:
+ *--------------------------------------
+*/
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdio.h>
+#include <cryptx.h>
+
+#define CEMU_CONSOLE ((char*)0xFB0000)
+#define DATA_LEN	1000
+#define CHUNK_LEN	64
+#define LEAVES		((DATA_LEN + CHUNK_LEN - 1) / CHUNK_LEN)
+
+uint8_t data[DATA_LEN];
+uint8_t root[CRYPTX_MERKLE_NODELEN];
+uint8_t path[CRYPTX_MERKLE_MAXDEPTH * CRYPTX_MERKLE_NODELEN];
+
+int main(void)
+{
+	uint8_t *tree;
+	size_t i = 7;
+
+	for(size_t j = 0; j < DATA_LEN; j++)
+		data[j] = (uint8_t)(j * 13);
+
+	if(!(tree = malloc(cryptx_merkle_tree_len(LEAVES))))
+		return 1;
+	cryptx_merkle_build(data, DATA_LEN, CHUNK_LEN, tree, root);
+
+	// one chunk checks out against the root
+	cryptx_merkle_path(tree, LEAVES, i, path);
+	sprintf(CEMU_CONSOLE, "chunk %u: %s\n", i,
+		cryptx_merkle_verify(&data[i * CHUNK_LEN], CHUNK_LEN, i, LEAVES, path, root) ? "valid" : "INVALID");
+
+	// and fails once a byte of it is changed
+	data[i * CHUNK_LEN] ^= 1;
+	sprintf(CEMU_CONSOLE, "tampered chunk %u: %s\n", i,
+		cryptx_merkle_verify(&data[i * CHUNK_LEN], CHUNK_LEN, i, LEAVES, path, root) ? "VALID" : "invalid");
+
+	// updating the tree for the change gives a new root that it verifies against
+	cryptx_merkle_update(tree, LEAVES, i, &data[i * CHUNK_LEN], CHUNK_LEN);
+	memcpy(root, &tree[cryptx_merkle_tree_len(LEAVES) - CRYPTX_MERKLE_NODELEN], CRYPTX_MERKLE_NODELEN);
+	cryptx_merkle_path(tree, LEAVES, i, path);
+	sprintf(CEMU_CONSOLE, "updated chunk %u: %s\n", i,
+		cryptx_merkle_verify(&data[i * CHUNK_LEN], CHUNK_LEN, i, LEAVES, path, root) ? "valid" : "INVALID");
+
+	// the short last chunk works too
+	i = LEAVES - 1;
+	cryptx_merkle_path(tree, LEAVES, i, path);
+	sprintf(CEMU_CONSOLE, "last chunk: %s\n",
+		cryptx_merkle_verify(&data[i * CHUNK_LEN], DATA_LEN - i * CHUNK_LEN, i, LEAVES, path, root) ? "valid" : "INVALID");
+
+	free(tree);
+	return 0;
+}
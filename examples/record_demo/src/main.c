@@ -0,0 +1,75 @@
+/*
+ *--------------------------------------
+ * Program Name:
+ * Author:
+ * License:
+ * Description:
+ *--------------------------------------
+*/
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdio.h>
+#include <cryptx.h>
+
+#define CEMU_CONSOLE ((char*)0xFB0000)
+
+// NIST GCM test case 4, which is the first record: its sequence number is 0, so its nonce is the iv
+const uint8_t key[CRYPTX_KEYLEN_AES128] = {
+	0xfe,0xff,0xe9,0x92,0x86,0x65,0x73,0x1c,0x6d,0x6a,0x8f,0x94,0x67,0x30,0x83,0x08
+};
+const uint8_t iv[CRYPTX_IVLEN_AES_RECORD] = {0xca,0xfe,0xba,0xbe,0xfa,0xce,0xdb,0xad,0xde,0xca,0xf8,0x88};
+const uint8_t header[20] = {
+	0xfe,0xed,0xfa,0xce,0xde,0xad,0xbe,0xef,0xfe,0xed,0xfa,0xce,0xde,0xad,0xbe,0xef,0xab,0xad,0xda,0xd2
+};
+const uint8_t payload[60] = {
+	0xd9,0x31,0x32,0x25,0xf8,0x84,0x06,0xe5,0xa5,0x59,0x09,0xc5,0xaf,0xf5,0x26,0x9a,
+	0x86,0xa7,0xa9,0x53,0x15,0x34,0xf7,0xda,0x2e,0x4c,0x30,0x3d,0x8a,0x31,0x8a,0x72,
+	0x1c,0x3c,0x0c,0x95,0x95,0x68,0x09,0x53,0x2f,0xcf,0x0e,0x24,0x49,0xa6,0xb5,0x25,
+	0xb1,0x6a,0xed,0xf5,0xaa,0x0d,0xe6,0x57,0xba,0x63,0x7b,0x39
+};
+const uint8_t expected_tag[CRYPTX_TAGLEN_AES_RECORD] = {
+	0x5b,0xc9,0x4f,0xbc,0x32,0x21,0xa5,0xdb,0x94,0xfa,0xe9,0x5a,0xe7,0x12,0x1a,0x47
+};
+
+// header, then payload, then room for the tag
+uint8_t record[sizeof header + sizeof payload + CRYPTX_TAGLEN_AES_RECORD];
+uint8_t sealed[sizeof record];
+struct cryptx_aes_record_ctx tx, rx;
+
+int main(void)
+{
+	bool ok = true;
+
+	cryptx_aes_record_init(&tx, key, sizeof key, iv);
+	cryptx_aes_record_init(&rx, key, sizeof key, iv);
+
+	// the first record matches the test vector
+	memcpy(record, header, sizeof header);
+	memcpy(&record[sizeof header], payload, sizeof payload);
+	cryptx_aes_record_seal(&tx, record, sizeof header, sizeof payload);
+	sprintf(CEMU_CONSOLE, "record 0 tag: %s\n",
+		memcmp(&record[sizeof header + sizeof payload], expected_tag, sizeof expected_tag) ? "FAIL" : "ok");
+	if(cryptx_aes_record_open(&rx, record, sizeof header, sizeof payload) != AES_OK) ok = false;
+	if(memcmp(&record[sizeof header], payload, sizeof payload)) ok = false;
+
+	// later records get a new nonce each, and a tampered record is rejected untouched
+	for(uint8_t i = 1; i < 4; i++){
+		memcpy(&record[sizeof header], payload, sizeof payload);
+		cryptx_aes_record_seal(&tx, record, sizeof header, i * 13);
+		memcpy(sealed, record, sizeof record);
+		record[0] ^= 1;
+		if(cryptx_aes_record_open(&rx, record, sizeof header, i * 13) != AES_INVALID_CIPHERTEXT) ok = false;
+		record[0] ^= 1;
+		if(cryptx_aes_record_open(&rx, record, sizeof header, i * 13) != AES_OK) ok = false;
+		if(memcmp(&record[sizeof header], payload, i * 13)) ok = false;
+	}
+
+	// replaying the last record does not open it again
+	memcpy(record, sealed, sizeof record);
+	if(cryptx_aes_record_open(&rx, record, sizeof header, 39) != AES_INVALID_CIPHERTEXT) ok = false;
+	sprintf(CEMU_CONSOLE, "seal/open/replay: %s\n", ok ? "ok" : "FAIL");
+	return 0;
+}
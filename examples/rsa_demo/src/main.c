@@ -32,6 +32,8 @@ int main(void)
     uint8_t str[] = "The daring fox jumped over the dog.";
 	uint8_t ciphertext[MODSIZE];
     uint8_t pubkey[MODSIZE];
+    uint8_t exponent[] = {0x01, 0x00, 0x01};
+    struct cryptx_rsa_pubkey_ctx ctx;
 	rsa_error_t error;
     
     // Always check for false return value from csrand_init()
@@ -49,5 +51,13 @@ int main(void)
 	error = cryptx_rsa_encrypt(str, strlen(str), pubkey, MODSIZE, ciphertext, SHA256);
 	sprintf(CEMU_CONSOLE, "RSA encrypt done, exit code %u: \n", error);
 	if(!error) hexdump(ciphertext, MODSIZE, "---RSA Encrypted---");
+	
+	// when encrypting to the same key repeatedly, set up a context once
+	error = cryptx_rsa_pubkey_init(&ctx, pubkey, MODSIZE, exponent, sizeof exponent);
+	sprintf(CEMU_CONSOLE, "RSA context init done, exit code %u: \n", error);
+	if(error) return 1;
+	error = cryptx_rsa_pubkey_encrypt(&ctx, str, strlen(str), ciphertext, SHA256);
+	sprintf(CEMU_CONSOLE, "RSA context encrypt done, exit code %u: \n", error);
+	if(!error) hexdump(ciphertext, ctx.keylen, "---RSA Encrypted (context)---");
     return 0;
 }
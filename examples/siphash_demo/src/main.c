@@ -0,0 +1,54 @@
+/*
+ *--------------------------------------
+ * Program Name:
+ * Author:
+ * License:
+ * Description:
+ *--------------------------------------
+*/
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdio.h>
+#include <cryptx.h>
+
+#define CEMU_CONSOLE ((char*)0xFB0000)
+
+// test vectors from the reference implementations: key 00 01 02 ..., message 00 01 02 ...
+// SipHash-2-4 of the 15 byte message, and HalfSipHash-2-4 of the empty message
+const uint8_t expected_siphash[CRYPTX_DIGESTLEN_SIPHASH] = {0xe5,0x45,0xbe,0x49,0x61,0xca,0x29,0xa1};
+const uint8_t expected_halfsiphash[CRYPTX_DIGESTLEN_HALFSIPHASH] = {0xa9,0x35,0x9f,0x5b};
+
+int main(void)
+{
+	uint8_t key[CRYPTX_KEYLEN_SIPHASH], msg[15];
+	uint8_t digest[CRYPTX_DIGESTLEN_SIPHASH], digest2[CRYPTX_DIGESTLEN_SIPHASH];
+	char hex[CRYPTX_DIGESTLEN_SIPHASH * 2 + 1];
+	struct cryptx_siphash_ctx ctx;
+
+	for(uint8_t i = 0; i < sizeof key; i++) key[i] = i;
+	for(uint8_t i = 0; i < sizeof msg; i++) msg[i] = i;
+
+	// one-shot
+	cryptx_siphash(key, msg, sizeof msg, digest, SIPHASH);
+	cryptx_bytes_tostring(digest, CRYPTX_DIGESTLEN_SIPHASH, hex);
+	sprintf(CEMU_CONSOLE, "SipHash-2-4: %s %s\n", hex,
+		memcmp(digest, expected_siphash, sizeof expected_siphash) ? "FAIL" : "ok");
+
+	// incremental, in uneven pieces, gives the same digest
+	cryptx_siphash_init(&ctx, key, SIPHASH);
+	cryptx_siphash_update(&ctx, msg, 3);
+	cryptx_siphash_update(&ctx, &msg[3], 9);
+	cryptx_siphash_update(&ctx, &msg[12], 3);
+	cryptx_siphash_digest(&ctx, digest2);
+	sprintf(CEMU_CONSOLE, "incremental: %s\n", memcmp(digest, digest2, sizeof digest) ? "FAIL" : "ok");
+
+	cryptx_siphash(key, NULL, 0, digest, HALFSIPHASH);
+	cryptx_bytes_tostring(digest, CRYPTX_DIGESTLEN_HALFSIPHASH, hex);
+	sprintf(CEMU_CONSOLE, "HalfSipHash-2-4: %s %s\n", hex,
+		memcmp(digest, expected_halfsiphash, sizeof expected_halfsiphash) ? "FAIL" : "ok");
+
+	return 0;
+}
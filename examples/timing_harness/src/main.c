@@ -0,0 +1,192 @@
+/*
+ *--------------------------------------
+ * Program Name:
+ * Author:
+ * License:
+ * Description:
+ *--------------------------------------
+*/
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+#include <tice.h>
+#include <sys/timers.h>
+#define CRYPTX_ENABLE_HAZMAT
+#include <cryptx.h>
+
+#define CEMU_CONSOLE ((char*)0xFB0000)
+
+// |t| above this means the two classes are distinguishable (the bound dudect uses)
+#define T_THRESHOLD	4.5f
+#define COMPARE_LEN	64
+#define MOD_LEN		32
+
+// Each primitive is timed with two classes of secret input: class 0 is one fixed value,
+// class 1 is fresh random data. The class is picked at random before every sample,
+// inputs are prepared outside of the measurement, and only the call itself is timed.
+// Welch's t-test then checks whether the two cycle count distributions differ.
+
+uint8_t key[32] = {
+	0xEE,0x89,0x19,0xC3,0x8D,0x53,0x7A,0xD6,0x04,0x19,0x9E,0x77,0x0B,0xE0,0xE0,0x4C,
+	0x4C,0x70,0xDB,0xE1,0x22,0x79,0xE1,0x90,0x06,0x1B,0xAF,0x99,0x49,0x8E,0x66,0x73
+};
+uint8_t iv[CRYPTX_BLOCKSIZE_AES] = {
+	0x79,0xA6,0xDE,0xDF,0xF0,0xA2,0x7C,0x7F,0xEE,0x0B,0x8E,0xF5,0x12,0x63,0xA4,0x8A
+};
+// odd, with the top bit of both end bytes set, so it reads as a valid modulus in either byte order
+uint8_t mod[MOD_LEN] = {
+	0xC5,0x1F,0x6A,0x93,0x2D,0x88,0x4E,0xB1,0x07,0x5C,0xE2,0x39,0x90,0x7B,0x14,0xAD,
+	0x63,0xF8,0x2E,0x41,0xD7,0x0A,0x9C,0x56,0xBB,0x32,0x81,0x6F,0xC9,0x15,0x74,0xE7
+};
+// sect233k1 base point, little-endian
+struct cryptx_ecc_point generator = {
+	{0x26,0x61,0xAD,0xEF,0x6E,0x9D,0x4C,0x0A,0xF5,0x6B,0xC2,0x19,0xA4,0x63,0x95,0x14,
+	 0xF4,0x2F,0xF2,0x29,0xF1,0x1A,0x73,0x7E,0x3A,0x85,0xBA,0x32,0x72,0x01},
+	{0xA3,0xE6,0xFA,0x56,0x10,0xC1,0xE0,0x56,0x9B,0xEB,0x8A,0xF1,0x9B,0xCD,0xA8,0x27,
+	 0xC4,0x67,0x5A,0x55,0x0F,0xF7,0xB7,0x19,0xE8,0xEC,0x7D,0x53,0xDB,0x01}
+};
+
+struct cryptx_aes_ctx aes;
+uint8_t secret[COMPARE_LEN], guess[COMPARE_LEN];
+uint8_t block[CRYPTX_BLOCKSIZE_AES], block_out[CRYPTX_BLOCKSIZE_AES];
+uint8_t base[MOD_LEN];
+struct cryptx_ecc_point point;
+
+// running mean and sum of squared deviations (Welford), one per class
+struct welch {
+	unsigned int n;
+	float mean;
+	float m2;
+};
+
+struct primitive {
+	const char *name;
+	unsigned int samples;
+	void (*prepare)(uint8_t class);
+	void (*run)(void);
+};
+
+void prepare_compare(uint8_t class){
+	// class 0 matches the secret everywhere, class 1 differs at a random point
+	memcpy(guess, secret, COMPARE_LEN);
+	if(class) cryptx_csrand_fill(guess, COMPARE_LEN);
+}
+void run_compare(void){
+	cryptx_bytes_compare(secret, guess, COMPARE_LEN);
+}
+
+void prepare_aes(uint8_t class){
+	if(class) cryptx_csrand_fill(block, sizeof block);
+	else memset(block, 0, sizeof block);
+}
+void run_aes(void){
+	cryptx_hazmat_aes_ecb_encrypt(block, block_out, &aes);
+}
+
+void prepare_powmod(uint8_t class){
+	if(class){
+		cryptx_csrand_fill(base, MOD_LEN);
+		base[0] &= 0x7f;
+		base[MOD_LEN-1] &= 0x7f;
+	}
+	else {
+		memset(base, 0, MOD_LEN);
+		base[0] = 1;
+		base[MOD_LEN-1] = 1;
+	}
+}
+void run_powmod(void){
+	cryptx_hazmat_powmod(MOD_LEN, base, 65537, mod);
+}
+
+void prepare_gf2(uint8_t class){
+	// point doubling is an inversion, two multiplications and two squarings in GF(2^233)
+	if(class){
+		cryptx_csrand_fill(&point, sizeof point);
+		point.x[CRYPTX_GF2_INTLEN-1] &= 1;
+		point.y[CRYPTX_GF2_INTLEN-1] &= 1;
+		point.x[0] |= 1;
+		point.y[0] |= 1;
+	}
+	else memcpy(&point, &generator, sizeof point);
+}
+void run_gf2(void){
+	cryptx_hazmat_ecc_point_double(&point);
+}
+
+struct primitive primitives[] = {
+	{"cryptx_bytes_compare", 4000, prepare_compare, run_compare},
+	{"aes ecb encrypt", 4000, prepare_aes, run_aes},
+	{"powmod", 2000, prepare_powmod, run_powmod},
+	{"gf2 point double", 1000, prepare_gf2, run_gf2}
+};
+
+// cycles spent in one call, measured with timer 1 at CPU speed
+uint32_t measure(void (*run)(void)){
+	timer_Disable(1);
+	timer_Set(1, 0);
+	timer_Enable(1, TIMER_CPU, TIMER_NOINT, TIMER_UP);
+	run();
+	timer_Disable(1);
+	return timer_Get(1);
+}
+
+void welch_push(struct welch *w, float x){
+	float delta = x - w->mean;
+	w->n++;
+	w->mean += delta / w->n;
+	w->m2 += delta * (x - w->mean);
+}
+
+float welch_t(struct welch *c){
+	float diff = c[0].mean - c[1].mean;
+	float se = c[0].m2 / (c[0].n - 1) / c[0].n + c[1].m2 / (c[1].n - 1) / c[1].n;
+	// exact cycle counts can have no spread at all; then any difference in means is a leak
+	if(se == 0.0f) return (diff == 0.0f) ? 0.0f : INFINITY;
+	return diff / sqrtf(se);
+}
+
+bool test_primitive(struct primitive *p){
+	struct welch classes[2] = {0};
+	uint32_t first = 0;
+	float t;
+
+	for(unsigned int i = 0; i < p->samples; i++){
+		uint8_t class = cryptx_csrand_get() & 1;
+		uint32_t cycles;
+		p->prepare(class);
+		cycles = measure(p->run);
+		// deviations from the first sample keep the floats small enough to stay exact
+		if(!i) first = cycles;
+		welch_push(&classes[class], (float)(int32_t)(cycles - first));
+	}
+	if(classes[0].n < 2 || classes[1].n < 2) return false;
+	t = welch_t(classes);
+	sprintf(CEMU_CONSOLE, "%-22s n=%u/%u mean=%lu/%lu t=%.2f %s\n",
+		p->name, classes[0].n, classes[1].n,
+		(unsigned long)(first + classes[0].mean), (unsigned long)(first + classes[1].mean),
+		t, (fabsf(t) > T_THRESHOLD) ? "LEAK" : "ok");
+	return fabsf(t) <= T_THRESHOLD;
+}
+
+int main(void)
+{
+	bool pass = true;
+
+	cryptx_csrand_fill(secret, COMPARE_LEN);
+	cryptx_aes_init(&aes, key, sizeof key, iv, sizeof iv, CRYPTX_AES_CBC, CRYPTX_AES_CBC_DEFAULTS);
+
+	sprintf(CEMU_CONSOLE, "\n-----------------------------------\nTiming Leakage (fixed vs random)\n\n");
+	for(uint8_t i = 0; i < sizeof primitives / sizeof primitives[0]; i++)
+		if(!test_primitive(&primitives[i])) pass = false;
+	sprintf(CEMU_CONSOLE, "%s\n", pass ? "PASS" : "FAIL");
+
+	// the autotester waits for a black screen, so a failed run times out there
+	if(pass) memset(lcd_Ram, 0, LCD_SIZE);
+	while(!os_GetCSC());
+	return 0;
+}
@@ -0,0 +1,93 @@
+/*
+ *--------------------------------------
+ * Program Name:
+ * Author:
+ * License:
+ * Description:
+ *--------------------------------------
+*/
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdio.h>
+#include <sys/timers.h>
+#include <cryptx.h>
+
+#define CEMU_CONSOLE ((char*)0xFB0000)
+
+// RFC 7748, section 6.1
+const uint8_t alice_privkey[CRYPTX_KEYLEN_X25519] = {
+	0x77, 0x07, 0x6d, 0x0a, 0x73, 0x18, 0xa5, 0x7d, 0x3c, 0x16, 0xc1, 0x72, 0x51, 0xb2, 0x66, 0x45,
+	0xdf, 0x4c, 0x2f, 0x87, 0xeb, 0xc0, 0x99, 0x2a, 0xb1, 0x77, 0xfb, 0xa5, 0x1d, 0xb9, 0x2c, 0x2a
+};
+const uint8_t bob_pubkey[CRYPTX_KEYLEN_X25519] = {
+	0xde, 0x9e, 0xdb, 0x7d, 0x7b, 0x7d, 0xc1, 0xb4, 0xd3, 0x5b, 0x61, 0xc2, 0xec, 0xe4, 0x35, 0x37,
+	0x3f, 0x83, 0x43, 0xc8, 0x5b, 0x78, 0x67, 0x4d, 0xad, 0xfc, 0x7e, 0x14, 0x6f, 0x88, 0x2b, 0x4f
+};
+const uint8_t expected[CRYPTX_KEYLEN_X25519] = {
+	0x4a, 0x5d, 0x9d, 0x5b, 0xa4, 0xce, 0x2d, 0xe1, 0x72, 0x8e, 0x3b, 0xf4, 0x80, 0x35, 0x0f, 0x25,
+	0xe0, 0x7e, 0x21, 0xc9, 0x47, 0xd1, 0x9e, 0x33, 0x76, 0xf0, 0x9b, 0x3c, 0x1e, 0x16, 0x17, 0x42
+};
+
+uint8_t privkey[CRYPTX_KEYLEN_X25519];
+uint8_t pubkey[CRYPTX_KEYLEN_X25519];
+uint8_t secret[CRYPTX_KEYLEN_X25519];
+uint8_t ec_privkey[CRYPTX_KEYLEN_EC_PRIVKEY];
+uint8_t ec_pubkey[CRYPTX_KEYLEN_EC_PUBKEY];
+uint8_t ec_secret[CRYPTX_KEYLEN_EC_SECRET];
+
+void hexdump(uint8_t *addr, size_t len, char *label){
+    if(label) sprintf(CEMU_CONSOLE, "\n%s\n", label);
+    else sprintf(CEMU_CONSOLE, "\n");
+    for(size_t rem_len = len, ct=1; rem_len>0; rem_len--, addr++, ct++){
+        sprintf(CEMU_CONSOLE, "%02X ", *addr);
+        if(!(ct%16)) sprintf(CEMU_CONSOLE, "\n");
+    }
+    sprintf(CEMU_CONSOLE, "\n");
+}
+
+// cycles between the two calls, measured with timer 1 at CPU speed
+void bench_start(void){
+	timer_Set(1, 0);
+	timer_Enable(1, TIMER_CPU, TIMER_NOINT, TIMER_UP);
+}
+
+uint32_t bench_stop(void){
+	timer_Disable(1);
+	return timer_Get(1);
+}
+
+int main(void)
+{
+	ec_error_t error;
+	uint32_t x25519, ecdh;
+	
+	sprintf(CEMU_CONSOLE, "\n------------------------------\nCryptX X25519 Demo\n------------------------------\n");
+	
+	error = cryptx_x25519_secret(alice_privkey, bob_pubkey, secret);
+	sprintf(CEMU_CONSOLE, "rfc 7748 secret, exit code %u, %s\n", error,
+			memcmp(secret, expected, sizeof secret) ? "mismatch (error)" : "match");
+	
+	error = cryptx_x25519_keygen(privkey, pubkey);
+	sprintf(CEMU_CONSOLE, "keygen complete, exit code %u\n", error);
+	hexdump(pubkey, sizeof pubkey, "-- public key --");
+	
+	// a peer sending zeros, a point of small order, must be refused
+	memset(pubkey, 0, sizeof pubkey);
+	error = cryptx_x25519_secret(privkey, pubkey, secret);
+	sprintf(CEMU_CONSOLE, "zero public key, exit code %u (expect %u)\n", error, EC_RPUBKEY_INVALID);
+	
+	bench_start();
+	cryptx_x25519_secret(alice_privkey, bob_pubkey, secret);
+	x25519 = bench_stop();
+	
+	cryptx_ec_keygen(ec_privkey, ec_pubkey);
+	bench_start();
+	cryptx_ec_secret(ec_privkey, ec_pubkey, ec_secret);
+	ecdh = bench_stop();
+	
+	sprintf(CEMU_CONSOLE, "\nx25519:          %lu cycles\nsect233k1 ecdh:  %lu cycles\n", x25519, ecdh);
+	return 0;
+}
@@ -0,0 +1,1172 @@
+#!/usr/bin/env python3
+# Static stack and cycle report for the exports of cryptx.asm.
+#
+#   python3 tools/stackreport.py cryptx.asm > cryptx_stack.txt
+#
+# The source is read the way fasmg would assemble the full library (CRYPTX, no
+# CRYPTX_STATS): conditional blocks are resolved, macros, iterate and repeat blocks
+# are expanded, and every export is followed through the calls and jumps it makes.
+#
+# Stack: the bytes an export needs below the caller's stack pointer once the
+# arguments are pushed, counting its return address. ti._frameset frames, push, pop,
+# pea and call/ret are tracked along every path, and ld sp, ix puts the pointer back
+# where the frame left it. A value ending in + is a lower bound, and the notes say why.
+#
+# Cycles: an estimate of the worst case at zero wait states, one cycle for every
+# byte fetched or moved to or from memory, one more for a taken jump, call or
+# return, and four more for mlt. Loops count only when the bound is in the code:
+# djnz, or dec then jr/jp nz, on a counter loaded with a constant before the loop,
+# and ldir with a constant bc. A counter a function takes in a register, such as b
+# for _ROTLEFT, comes from the constant the caller loads before the call, so such a
+# function is estimated once for each constant it is called with. A register keeps
+# its value across a call that cannot change it.
+#
+# Where a counter is set in a way that cannot be followed, a comment on the line
+# that sets it gives the value, "; sets: b = 1", or the most it can be, "; sets:
+# bc <= 4096", and either is taken as the count. "; bound: 64" on the jump that
+# closes a loop gives the most times the loop runs. Anything else, such as loops
+# over a length argument or calls into the toolchain runtime, makes the estimate
+# -, and the notes say why.
+#
+# Indirect calls are followed when the call line says where it goes, with a
+# comment of the form "; calls: target, target". "; calls: callback" marks a
+# pointer supplied by the program, which is not counted.
+#
+# Exports that loop over a length have no figure, so the routines they run once a
+# block are listed after the exports, to work one out for a given length.
+
+import re
+import sys
+
+RUNTIME_STACK = 6		# bytes a ti._ runtime routine is taken to use beyond its return address
+
+R8 = {'a', 'b', 'c', 'd', 'e', 'h', 'l'}
+RI8 = {'ixh', 'ixl', 'iyh', 'iyl'}
+R24 = {'bc', 'de', 'hl', 'sp', 'ix', 'iy', 'af'}
+CONDS = {'z', 'nz', 'c', 'nc', 'p', 'm', 'pe', 'po'}
+DATA = {'db', 'dw', 'dl', 'dd', 'rb', 'rw', 'rl', 'rd', 'emit', 'dbx'}
+IGNORE = {'include', 'library', 'err', 'local', 'align', 'assert', 'display', 'private', 'public', 'section'}
+CB_OPS = {'rlc', 'rrc', 'rl', 'rr', 'sla', 'sra', 'srl', 'bit', 'set', 'res'}
+ALU = {'add', 'adc', 'sub', 'sbc', 'and', 'or', 'xor', 'cp', 'tst'}
+ED_ONE = {'neg', 'rld', 'rrd', 'reti', 'retn', 'im', 'stmix', 'rsmix', 'slp', 'ldi', 'ldd', 'cpi', 'cpd'}
+REPEAT = {'ldir', 'lddr', 'cpir', 'cpdr', 'otir', 'inir', 'otimr', 'oti2r'}
+BLOCKS = [
+	('_sha256_transform', 'SHA-256, 64 bytes'),
+	('_sha1_transform', 'SHA-1, 64 bytes'),
+	('_chacha_block', 'ChaCha20, 64 bytes'),
+	('_poly_block', 'Poly1305, 16 bytes'),
+	('_sip_compress', 'SipHash, one 8 byte word'),
+]
+PAIRS = {'b': 'bc', 'c': 'bc', 'd': 'de', 'e': 'de', 'h': 'hl', 'l': 'hl', 'a': 'af',
+	'ixh': 'ix', 'ixl': 'ix', 'iyh': 'iy', 'iyl': 'iy'}
+
+
+class Insn:
+	def __init__(self, line, scope, mn, ops, comment):
+		self.line = line
+		self.scope = scope
+		self.mn = mn
+		self.ops = ops
+		self.comment = comment
+
+
+def split_comment(text):
+	quote = None
+	for i, ch in enumerate(text):
+		if quote:
+			if ch == quote:
+				quote = None
+		elif ch in '\'"':
+			quote = ch
+		elif ch == ';':
+			return text[:i], text[i + 1:]
+	return text, ''
+
+
+def split_ops(text):
+	ops, depth, cur, quote = [], 0, '', None
+	for ch in text:
+		if quote:
+			cur += ch
+			if ch == quote:
+				quote = None
+			continue
+		if ch in '\'"':
+			quote = ch
+		elif ch == '(':
+			depth += 1
+		elif ch == ')':
+			depth -= 1
+		elif ch == ',' and depth == 0:
+			ops.append(cur.strip())
+			cur = ''
+			continue
+		cur += ch
+	if cur.strip():
+		ops.append(cur.strip())
+	return ops
+
+
+def substitute(text, names, values):
+	for name, value in zip(names, values):
+		text = re.sub(r'(?<![\w.])' + re.escape(name) + r'(?![\w])', value, text)
+	return text
+
+
+class Source:
+	def __init__(self, path):
+		self.insns = []
+		self.labels = {}
+		self.consts = {}
+		self.macros = {}
+		self.exports = []
+		self.pointers = []			# labels stored in tables, such as hash_func_lookup
+		self.scope = ''
+		self.pending = []
+		self.expansions = 0
+		with open(path) as f:
+			self.process(f.read().split('\n'), 1)
+
+	# collects the lines of a block up to its matching end, counting nested blocks of the same kind
+	@staticmethod
+	def block(lines, i, kinds):
+		depth, body = 1, []
+		while i < len(lines):
+			code = split_comment(lines[i][1])[0].strip().lower()
+			word = code.split(None, 1)[0] if code else ''
+			if word in kinds:
+				depth += 1
+			elif code.startswith('end ') and code[4:].strip() in kinds:
+				depth -= 1
+				if not depth:
+					return body, i + 1
+			body.append(lines[i])
+			i += 1
+		raise SystemExit('unterminated block')
+
+	def condition(self, cond):
+		cond = cond.strip()
+		if 'CRYPTX_STATS' in cond or 'CRYPTX_MODULE' in cond:
+			return False
+		if re.match(r'^defined\s+cryptx_(code|exports)\.\w+$', cond):
+			return True
+		value = self.evaluate(re.sub(r'(?<![<>=!])=(?!=)', '==', cond))
+		return bool(value) if value is not None else True
+
+	def process(self, raw, first):
+		lines = [(first + n, text) if isinstance(text, str) else text for n, text in enumerate(raw)]
+		self.process_lines(lines)
+
+	def process_lines(self, lines):
+		i, conds = 0, []
+		while i < len(lines):
+			number, text = lines[i]
+			code, comment = split_comment(text)
+			code = code.strip()
+			i += 1
+			if not code:
+				continue
+			low = code.lower()
+			word = low.split(None, 1)[0]
+			# conditional assembly
+			if word == 'if':
+				active = all(c[0] for c in conds)
+				taken = active and self.condition(code[2:])
+				conds.append([taken, taken])
+				continue
+			if low.startswith('else if'):
+				c = conds[-1]
+				c[0] = not c[1] and all(x[0] for x in conds[:-1]) and self.condition(code[7:])
+				c[1] = c[1] or c[0]
+				continue
+			if word == 'else':
+				c = conds[-1]
+				c[0] = not c[1]
+				c[1] = True
+				continue
+			if low.startswith('end if'):
+				conds.pop()
+				continue
+			if not all(c[0] for c in conds):
+				if word in ('macro', 'virtual', 'iterate', 'irpv', 'repeat', 'rept', 'while'):
+					kind = 'rept' if word == 'rept' else word
+					_, i = self.block(lines, i, {kind})
+				continue
+			if word == 'macro':
+				name, params = (code.split(None, 2)[1:] + [''])[:2]
+				name = name.rstrip('?').lower()
+				body, i = self.block(lines, i, {'macro'})
+				self.macros[name] = ([p.strip().rstrip('*?') for p in params.split(',') if p.strip()], body)
+				continue
+			if word == 'virtual':
+				body, i = self.block(lines, i, {'virtual'})
+				self.structure(code.split(None, 1)[1], body)
+				continue
+			if word in ('irpv', 'while'):
+				_, i = self.block(lines, i, {word})
+				continue
+			if word == 'iterate':
+				var, _, values = code.split(None, 1)[1].partition(',')
+				body, i = self.block(lines, i, {'iterate'})
+				values = split_ops(values)
+				for n, value in enumerate(values):
+					self.process_lines([(num, substitute(t, [var.strip(), '%', '%%'], [value, str(n + 1), str(len(values))])) for num, t in body])
+				continue
+			if word == 'repeat':
+				count = self.evaluate(code.split(None, 1)[1]) or 0
+				body, i = self.block(lines, i, {'repeat'})
+				for n in range(count):
+					self.process_lines([(num, substitute(t, ['%', '%%'], [str(n + 1), str(count)])) for num, t in body])
+				continue
+			self.statement(number, code, comment)
+
+	# offsets of the fields laid out in a virtual block, such as a context structure
+	def structure(self, origin, body):
+		m = re.match(r'^at\s+(.*)$', origin.strip())
+		here = self.evaluate(m.group(1)) if m else None
+		for _, text in body:
+			code = split_comment(text)[0].strip()
+			m = re.match(r'^([A-Za-z_.?][\w.?]*)(:|\s+(rb|db|rl|dl)\b\s*(.*))$', code)
+			if here is None or not m:
+				continue
+			self.consts[m.group(1)] = (str(here), self.scope)
+			if m.group(3):
+				size = self.evaluate(m.group(4)) if m.group(3) in ('rb', 'rl') else len(split_ops(m.group(4)))
+				if size is None:
+					here = None
+				else:
+					here += size * (3 if m.group(3) in ('rl', 'dl') else 1)
+
+	def statement(self, number, code, comment):
+		# labels, possibly followed by a statement on the same line
+		m = re.match(r'^([A-Za-z_.?][\w.?]*):(?!=)\s*(.*)$', code)
+		if m:
+			self.label(m.group(1))
+			if m.group(2):
+				self.statement(number, m.group(2), comment)
+			return
+		m = re.match(r'^([A-Za-z_.?][\w.?]*)\s*(:=|=|equ\b)\s*(.*)$', code)
+		if m:
+			name, value = self.qualify(m.group(1)), m.group(3).strip()
+			if value == '$':
+				self.pending.append(name)
+			else:
+				self.consts[name] = (value, self.scope)
+			return
+		word, rest = (code.split(None, 1) + [''])[:2]
+		word = word.lower()
+		rest = rest.strip()
+		if word in IGNORE:
+			return
+		if word == 'export':
+			self.exports.append(rest)
+			return
+		if word in self.macros:
+			params, body = self.macros[word]
+			args = split_ops(rest)
+			args += [''] * (len(params) - len(args))
+			# local names get a new symbol for every expansion, as in fasmg
+			names = [n.strip() for _, t in body for w, n in [(split_comment(t)[0].split(None, 1) + ['', ''])[:2]]
+					 if w.lower() == 'local' for n in n.split(',')]
+			self.expansions += 1
+			params, args = params + names, args + ['%s?%d' % (n, self.expansions) for n in names]
+			self.process_lines([(number, substitute(t, params, args)) for _, t in body])
+			return
+		# rl is also the rotate instruction
+		if (word in DATA and word != 'rl') or (rest.split(None, 1)[0].lower() if rest else '') in DATA:
+			if word in ('dl', 'rl'):
+				self.pointers += [self.qualify(o) for o in split_ops(rest) if re.match(r'^[A-Za-z_.][\w.]*$', o)]
+			self.emit(Insn(number, self.scope, 'data', [], comment))
+			return
+		self.emit(Insn(number, self.scope, word, split_ops(rest), comment))
+
+	def qualify(self, name):
+		name = name.lstrip('?')
+		return self.scope + name if name.startswith('.') else name
+
+	def label(self, name):
+		name = name.lstrip('?')
+		if not name.startswith('.'):
+			self.scope = name
+		self.pending.append(self.qualify(name))
+
+	def emit(self, insn):
+		for name in self.pending:
+			self.labels[name] = len(self.insns)
+		self.pending = []
+		self.insns.append(insn)
+
+	def evaluate(self, expr, scope='', depth=0):
+		if depth > 32:
+			return None
+		expr = expr.strip()
+		out = []
+		for tok in re.findall(r'\$[0-9A-Fa-f]+|0x[0-9A-Fa-f]+|[0-9][0-9A-Fa-f]*h\b|%[01]+\b|\d+|[A-Za-z_.?][\w.?]*|<=|>=|==|<>|\S', expr):
+			low = tok.lower()
+			if tok.startswith('$') and len(tok) > 1:
+				out.append(str(int(tok[1:], 16)))
+			elif low.startswith('0x'):
+				out.append(str(int(tok, 16)))
+			elif re.match(r'^[0-9][0-9a-f]*h$', low):
+				out.append(str(int(tok[:-1], 16)))
+			elif tok.startswith('%') and len(tok) > 1:
+				out.append(str(int(tok[1:], 2)))
+			elif tok.isdigit():
+				out.append(tok)
+			elif low in ('shl', 'shr', 'and', 'or', 'xor', 'not', 'mod'):
+				out.append({'shl': '<<', 'shr': '>>', 'and': '&', 'or': '|', 'xor': '^', 'not': '~', 'mod': '%'}[low])
+			elif low in ('ix', 'iy'):
+				out.append('0')
+			elif low in ('byte', 'word', 'long', 'dword'):
+				out.append({'byte': '1', 'word': '2', 'long': '3', 'dword': '4'}[low])
+			elif re.match(r'^[A-Za-z_.?]', tok):
+				name = (scope + tok) if tok.startswith('.') else tok
+				if name not in self.consts:
+					return None
+				value, where = self.consts[name]
+				value = self.evaluate(value, where, depth + 1)
+				if value is None:
+					return None
+				out.append('(%d)' % value)
+			elif tok in ('<=', '>=', '==', '<>'):
+				out.append('!=' if tok == '<>' else tok)
+			elif tok in '+-*/()<>=!~&|^%':
+				out.append('//' if tok == '/' else tok)
+			else:
+				return None
+		try:
+			return int(eval(' '.join(out), {'__builtins__': {}}))
+		except Exception:
+			return None
+
+
+def operand_class(op):
+	o = op.strip().lower()
+	if o in R8:
+		return 'r'
+	if o in RI8:
+		return 'ri'
+	if o in ('ix', 'iy'):
+		return 'xy'
+	if o in R24:
+		return 'rr'
+	if o in ('i', 'r', 'mb'):
+		return 'special'
+	if o.startswith('(') and o.endswith(')') and o.count('(') == 1:
+		inner = o[1:-1].strip()
+		if inner == 'hl':
+			return 'mhl'
+		if inner in ('bc', 'de'):
+			return 'mrr'
+		if inner == 'sp':
+			return 'msp'
+		if inner == 'c':
+			return 'io'
+		if re.match(r'^i[xy]\b', inner):
+			return 'mxy'
+		return 'mnn'
+	if re.match(r'^i[xy]\s*[-+]', o):
+		return 'xyd'
+	return 'imm'
+
+
+def width(op):
+	o = op.strip().lower()
+	return 3 if o in R24 else 1
+
+
+def timing(insn):
+	"""(cycles, cycles per repeat, extra cycles when the branch is taken)"""
+	mn, ops = insn.mn, insn.ops
+	cls = [operand_class(o) for o in ops]
+	size, mem, extra, taken = 1, 0, 0, 0
+	if any(c in ('xy', 'ri', 'mxy', 'xyd') for c in cls):
+		size += 1
+	if any(c in ('mxy', 'xyd') for c in cls) and mn not in ('lea', 'pea'):
+		size += 1
+	memops = [i for i, c in enumerate(cls) if c in ('mhl', 'mrr', 'mxy', 'mnn', 'msp')]
+	if mn == 'ld':
+		dst, src = (cls + ['', ''])[:2]
+		if 'mnn' in cls:
+			size += 3
+		if src == 'imm':
+			size += 3 if ops[0].lower() in R24 else 1
+		if memops:
+			other = ops[1 - memops[0]] if len(ops) == 2 else 'a'
+			mem += width(other)
+			if width(other) == 3 and (('mhl' in cls) or ('mnn' in cls and other.lower() not in ('hl', 'ix', 'iy'))):
+				size += 1
+		if 'special' in cls:
+			size += 1
+	elif mn in ('push', 'pop'):
+		size = sum(2 if o.lower() in ('ix', 'iy') else 1 for o in ops)
+		mem = 3 * len(ops)
+	elif mn == 'pea':
+		size, mem = 3, 3
+	elif mn == 'lea':
+		size = 3
+	elif mn in ALU:
+		if len(ops) == 2 and ops[0].lower() in ('hl', 'ix', 'iy'):
+			if mn in ('adc', 'sbc'):
+				size += 1
+		else:
+			if cls[-1] == 'imm':
+				size += 1
+			if mn == 'tst':
+				size += 1
+			if memops:
+				mem += 1
+	elif mn in ('inc', 'dec'):
+		if memops:
+			mem += 2
+	elif mn in CB_OPS:
+		size += 1
+		if memops:
+			mem += 1 if mn == 'bit' else 2
+	elif mn == 'mlt':
+		size, extra = 2, 4
+	elif mn in ED_ONE:
+		size = 2
+		if mn in ('rld', 'rrd', 'ldi', 'ldd'):
+			mem = 2
+		elif mn in ('cpi', 'cpd'):
+			mem = 1
+		elif mn in ('reti', 'retn'):
+			mem, extra = 3, 1
+	elif mn in REPEAT:
+		return 2, 3, 0
+	elif mn == 'ex':
+		if 'msp' in cls:
+			mem = 6
+	elif mn in ('in0', 'out0'):
+		size, mem = 3, 1
+	elif mn in ('in', 'out'):
+		size, mem = 2, 1
+	elif mn in ('jp', 'jq'):
+		if ops and ops[-1].strip().startswith('('):
+			extra = 1
+		else:
+			size = 4
+			if len(ops) == 1:
+				extra = 1
+			else:
+				taken = 1
+	elif mn in ('jr', 'djnz'):
+		size = 2
+		if mn == 'jr' and len(ops) == 1:
+			extra = 1
+		else:
+			taken = 1
+	elif mn == 'call':
+		size = 4
+		if len(ops) == 1:
+			mem, extra = 3, 1
+		else:
+			taken = 4
+	elif mn == 'ret':
+		if ops:
+			taken = 4
+		else:
+			mem, extra = 3, 1
+	elif mn == 'rst':
+		mem, extra = 3, 1
+	return size + mem + extra, 0, taken
+
+
+class Result:
+	def __init__(self):
+		self.stack = 0				# deepest point below the entry stack pointer, return address not counted
+		self.stack_why = set()		# why the stack figure is only a lower bound
+		self.cycles = 0
+		self.cycle_why = set()		# why there is no cycle figure
+
+
+class Analyzer:
+	def __init__(self, src):
+		self.src = src
+		self.results = {}
+		self.given = {}			# cycles of a function for the constant registers a caller enters it with
+		self.clobbered = {}		# (function, register): whether a call to the function can change the register
+		self.active = set()
+		self.returns = set()		# indirect jumps made after popping the return address, so returns
+		# labels entered from elsewhere: called, exported, named in a calls: comment, used as a
+		# pointer, or jumped to from more than one place. any other label is part of the code around it
+		self.entries = {}
+		jumps = {}
+		for insn in src.insns:
+			names = [self.resolve(insn, o) for o in insn.ops if re.match(r'^[A-Za-z_.][\w.]*$', o.strip())]
+			if insn.mn in ('jp', 'jq', 'jr', 'djnz'):
+				for name in names:
+					if name and not name.startswith(insn.scope + '.'):
+						jumps.setdefault(name, set()).add(insn.scope)
+			elif insn.mn != 'data':
+				for name in names:
+					if name and not name.startswith('ti.'):
+						self.entries[src.labels[name]] = name
+			m = re.search(r'calls:\s*(.*)$', insn.comment)
+			for name in re.split(r'[\s,]+', m.group(1).strip()) if m else ():
+				name = self.resolve(insn, name)
+				if name and not name.startswith('ti.'):
+					self.entries[src.labels[name]] = name
+		for name, scopes in jumps.items():
+			if len(scopes) > 1 and not name.startswith('ti.'):
+				self.entries[src.labels[name]] = name
+		for name in src.exports + src.pointers:
+			name = self.resolve(Insn(0, '', '', [], ''), name)
+			if name:
+				self.entries[src.labels[name]] = name
+
+	def resolve(self, insn, name):
+		"""the label a name refers to, following aliases such as cryptx_hash_init = hash_init"""
+		name = name.strip()
+		if name == '.':
+			name = insn.scope
+		elif name.startswith('.'):
+			name = insn.scope + name
+		seen = set()
+		while name not in self.src.labels and name in self.src.consts and name not in seen:
+			seen.add(name)
+			name = self.src.consts[name][0].strip()
+		if name in self.src.labels or name.startswith('ti.'):
+			return name
+		return None
+
+	def targets(self, insn):
+		"""the functions an indirect call or jump goes to, from its calls: comment"""
+		m = re.search(r'calls:\s*(.*)$', insn.comment)
+		if not m:
+			return ['?indirect']
+		names = [n for n in re.split(r'[\s,]+', m.group(1).strip()) if n]
+		return [n if n == 'callback' else (self.resolve(insn, n) or '?' + n) for n in names]
+
+	def callees(self, insn):
+		name = insn.ops[-1].strip()
+		if name in ('_indcallhl', '_indcall'):
+			return self.targets(insn)
+		return [self.resolve(insn, name) or '?' + name]
+
+	def flow(self, i, entry):
+		"""(kind, value, taken) for every way out of instruction i, kind being jump, tail, ret, ijump or stop"""
+		insns = self.src.insns
+		insn = insns[i]
+		mn, ops = insn.mn, insn.ops
+		out = []
+
+		def branch(name, taken):
+			target = self.resolve(insn, name)
+			if target is None:
+				out.append(('stop', 'unresolved ' + name.strip(), taken))
+			elif target.startswith('ti.'):
+				out.append(('tail', target, taken))
+			elif self.src.labels[target] in self.entries and self.src.labels[target] != entry:
+				out.append(('tail', target, taken))
+			else:
+				out.append(('jump', self.src.labels[target], taken))
+
+		def fall():
+			j = i + 1
+			if j >= len(insns) or insns[j].mn == 'data':
+				out.append(('stop', 'runs into data', False))
+			elif j in self.entries:
+				out.append(('tail', self.entries[j], False))
+			else:
+				out.append(('jump', j, False))
+
+		conditional = len(ops) == 2 and ops[0].strip().lower() in CONDS
+		if mn in ('jp', 'jq', 'jr'):
+			if ops[-1].strip().startswith('('):
+				out.append(('ijump', None, True))
+			else:
+				branch(ops[-1], True)
+			if conditional:
+				fall()
+		elif mn == 'djnz':
+			branch(ops[0], True)
+			fall()
+		elif mn in ('ret', 'reti', 'retn'):
+			out.append(('ret', None, True))
+			if ops:
+				fall()
+		elif mn == 'data':
+			out.append(('stop', 'runs into data', False))
+		else:
+			fall()
+		return out
+
+	def function(self, name):
+		if name in self.results:
+			return self.results[name]
+		result = Result()
+		if name.startswith('ti.'):
+			result.stack = RUNTIME_STACK
+			result.cycles = None
+			if name in ('ti.ChkFindSym', 'ti.ChkInRam'):
+				result.stack_why.add('os')
+				result.cycle_why.add('os')
+			else:
+				result.cycle_why.add(name)
+			return result
+		if name == 'callback' or name.startswith('?'):
+			why = 'callback' if name == 'callback' else 'indirect' if name == '?indirect' else 'unresolved ' + name[1:]
+			result.stack_why.add(why)
+			result.cycles = None
+			result.cycle_why.add(why)
+			return result
+		if name in self.active:
+			result.stack_why.add('recursive')
+			result.cycles = None
+			result.cycle_why.add('recursive')
+			return result
+		self.active.add(name)
+		self.stack(self.src.labels[name], result)
+		self.wcet(name, self.src.labels[name], result)
+		self.active.discard(name)
+		self.results[name] = result
+		return result
+
+	def entered(self, name, given):
+		"""the cycles of a function entered with the registers in given holding constants"""
+		r = self.function(name)
+		if r.cycles is not None or not given or name.startswith(('ti.', '?')) or name == 'callback':
+			return r
+		key = (name, tuple(sorted(given.items())))
+		if key in self.given:
+			return self.given[key]
+		result = Result()
+		if name in self.active:
+			result.cycles = None
+			result.cycle_why.add('recursive')
+			return result
+		self.active.add(name)
+		self.wcet(name, self.src.labels[name], result, given)
+		self.active.discard(name)
+		self.given[key] = result
+		return result
+
+	def constants(self, i, entry, given, through=False):
+		"""the loop counters holding a constant when instruction i is reached, or left by it if through"""
+		if through:
+			values = {c: self.counter_init(i + 1, c, entry, given, True) for c in ('b', 'c')}
+		else:
+			values = {c: self.counter_init(i, c, entry, given) for c in ('b', 'c')}
+			values['bc'] = self.repeat_count(i, entry, given)
+		return {c: v for c, v in values.items() if v is not None}
+
+	# --- stack ---------------------------------------------------------------
+
+	def stack(self, entry, result):
+		insns = self.src.insns
+		states, visits = {}, {}
+		work = [(entry, 0, None, None)]
+		deepest = 0
+
+		def into(callee, depth):
+			nonlocal deepest
+			r = self.function(callee)
+			deepest = max(deepest, depth + r.stack)
+			result.stack_why |= r.stack_why
+
+		while work:
+			i, offset, ix, hl = work.pop()
+			# where paths meet, keep the deeper offset and forget a frame pointer they disagree on
+			if i in states:
+				last = states[i]
+				if offset > last[0]:
+					visits[i] = visits.get(i, 0) + 1
+					if visits[i] > 16:
+						result.stack_why.add('stack grows in a loop')
+						continue
+				offset = max(offset, last[0])
+				ix = ix if ix == last[1] else None
+				hl = hl if hl == last[2] else None
+				if (offset, ix, hl) == last:
+					continue
+			states[i] = (offset, ix, hl)
+			deepest = max(deepest, offset)
+			insn = insns[i]
+			mn, ops = insn.mn, [o.lower().replace(' ', '') for o in insn.ops]
+			newhl = None
+			if mn == 'push':
+				offset += 3 * len(ops)
+			elif mn == 'pop':
+				offset -= 3 * len(ops)
+				if 'ix' in ops:
+					ix = None
+			elif mn == 'pea':
+				offset += 3
+			elif mn in ('inc', 'dec') and ops == ['sp']:
+				offset += 1 if mn == 'dec' else -1
+			elif mn == 'ld' and ops[0] == 'sp':
+				m = re.search(r'stack:\s*ix\s*-\s*(\d+)', insn.comment)
+				if ops[1] == 'ix' and isinstance(ix, int):
+					offset = ix
+				elif ops[1] == 'ix':
+					pass		# back up into a frame made before this function was entered
+				elif ops[1] == 'hl' and isinstance(hl, tuple):
+					offset = hl[1]
+				elif m and isinstance(ix, int):
+					offset = ix + int(m.group(1))
+				else:
+					result.stack_why.add('dynamic')
+			elif mn == 'ld' and ops[0] == 'ix':
+				v = self.src.evaluate(insn.ops[1], insn.scope) if operand_class(insn.ops[1]) == 'imm' else None
+				ix = ('const', v) if v is not None else None
+			elif mn == 'add' and ops == ['ix', 'sp']:
+				ix = offset - ix[1] if isinstance(ix, tuple) else None
+			elif mn == 'lea' and ops[0] == 'ix':
+				m = re.match(r'^ix([-+].*)?$', ops[1])
+				v = self.src.evaluate(m.group(1) or '0', insn.scope) if m and isinstance(ix, int) else None
+				ix = ix - v if v is not None else None
+			elif ops and ops[0] == 'ix':
+				ix = None
+			elif mn == 'ld' and ops[0] == 'hl' and operand_class(insn.ops[1]) == 'imm':
+				newhl = self.src.evaluate(insn.ops[1], insn.scope)
+			elif mn == 'add' and ops == ['hl', 'sp'] and isinstance(hl, int):
+				newhl = ('sp', offset - hl)
+			elif mn == 'call':
+				target = self.resolve(insn, insn.ops[-1])
+				if target in ('ti._frameset', 'ti._frameset0'):
+					deepest = max(deepest, offset + 3)
+					offset += 3
+					ix = offset
+					if target == 'ti._frameset' and isinstance(hl, int):
+						offset -= hl
+					elif target == 'ti._frameset':
+						result.stack_why.add('dynamic')
+				else:
+					for callee in self.callees(insn):
+						into(callee, offset + 3)
+			hl = newhl
+			deepest = max(deepest, offset)
+			for kind, value, _ in self.flow(i, entry):
+				if kind == 'jump':
+					work.append((value, offset, ix, hl))
+				elif kind == 'tail':
+					into(value, offset)
+				elif kind == 'ijump':
+					if offset < 0:
+						self.returns.add(i)
+					else:
+						for callee in self.targets(insn):
+							into(callee, offset)
+				elif kind == 'stop':
+					result.stack_why.add(value)
+		result.stack = deepest
+
+	# --- cycles --------------------------------------------------------------
+
+	@staticmethod
+	def writes(insn, counter):
+		"""whether insn can change a loop counter, a register or (ix+d)"""
+		mn, ops = insn.mn, [o.lower().replace(' ', '') for o in insn.ops]
+		pair = PAIRS.get(counter)
+		if mn in ('call', 'rst'):
+			return True
+		if counter == 'b' and mn in REPEAT | {'djnz', 'ldi', 'ldd', 'cpi', 'cpd'}:
+			return True
+		if counter == 'c' and mn in REPEAT | {'ldi', 'ldd', 'cpi', 'cpd'}:
+			return True
+		if mn in ('pop', 'mlt') and pair in ops:
+			return True
+		if mn in ('ex', 'exx'):
+			return mn == 'exx' or pair in ops
+		if counter.startswith('('):
+			return mn not in ('cp', 'bit', 'push', 'tst') and bool(ops) and ops[0] == counter or (
+				mn in CB_OPS and mn != 'bit' and ops[-1] == counter)
+		if not ops:
+			return counter == 'a' and mn in ('cpl', 'neg', 'rla', 'rra', 'rlca', 'rrca', 'daa', 'rld', 'rrd')
+		if mn in ('cp', 'bit', 'push', 'pea', 'tst', 'out', 'out0', 'jp', 'jq', 'jr', 'djnz', 'ret'):
+			return False
+		if mn in ALU and (len(ops) == 1 or ops[0] == 'a'):
+			return counter == 'a'
+		dst = ops[-1] if mn in ('set', 'res') else ops[0]
+		return dst == counter or dst == pair
+
+	def clobbers(self, name, reg):
+		"""whether calling name can change reg, following its calls; anything not followed can"""
+		if name.startswith(('ti.', '?')) or name == 'callback':
+			return True
+		key = (name, reg)
+		if key in self.clobbered:
+			return self.clobbered[key]
+		self.clobbered[key] = True			# a recursive call is taken to change it
+		entry = self.src.labels[name]
+		seen, work, found = set(), [entry], False
+		while work and not found:
+			i = work.pop()
+			if i in seen:
+				continue
+			seen.add(i)
+			insn = self.src.insns[i]
+			if insn.mn == 'call':
+				found = any(self.clobbers(c, reg) for c in self.callees(insn))
+			elif self.writes(insn, reg):
+				found = True
+			for kind, value, _ in self.flow(i, entry):
+				if kind == 'jump':
+					work.append(value)
+				elif kind == 'tail':
+					found = found or self.clobbers(value, reg)
+				elif kind in ('ijump', 'stop'):
+					found = True
+		self.clobbered[key] = found
+		return found
+
+	def constant(self, op, scope):
+		"""the value of an immediate operand, None for memory, registers and anything else"""
+		return self.src.evaluate(op, scope) if operand_class(op) == 'imm' else None
+
+	def annotated(self, insn, reg):
+		"""the value a sets: comment gives reg, or the b or c half of it, if the line has one"""
+		m = re.search(r'sets:\s*(\w+)\s*<?=\s*([^,;]+)', insn.comment)
+		if not m:
+			return None
+		name = m.group(1).lower()
+		if name == reg:
+			return self.src.evaluate(m.group(2), insn.scope)
+		if name == 'bc' and reg in ('b', 'c'):
+			v = self.src.evaluate(m.group(2), insn.scope)
+			return None if v is None else (v >> 8 if reg == 'b' else v) & 0xFF
+		return None
+
+	def counter_init(self, header, counter, entry=None, given=None, through=False):
+		"""the value of a loop counter on entry, from a constant load before the loop or the caller,
+		through being set when header is a function the line before runs into"""
+		insns = self.src.insns
+		j = header - 1
+		while j >= 0 and (j + 1 not in self.entries or through and j == header - 1):
+			insn = insns[j]
+			ops = [o.lower().replace(' ', '') for o in insn.ops]
+			v = self.annotated(insn, counter)
+			if v is not None:
+				return v
+			if insn.mn == 'ld' and ops[0] == counter and ops[1] in R8:
+				return self.counter_init(j, ops[1], entry, given)
+			if insn.mn == 'ld' and ops[0] == counter:
+				return self.constant(insn.ops[1], insn.scope)
+			if insn.mn == 'ld' and ops[0] == PAIRS.get(counter) and ops[0] in R24:
+				v = self.constant(insn.ops[1], insn.scope)
+				return None if v is None else (v >> 8 if counter in ('b', 'd', 'h', 'ixh', 'iyh') else v) & 0xFF
+			if insn.mn == 'call' and not any(self.clobbers(c, counter) for c in self.callees(insn)):
+				j -= 1
+				continue
+			# falling through a branch leaves the counter as it was, and so does one that goes to the header
+			if insn.mn in ('jp', 'jq', 'jr') and len(ops) == 2 and ops[0] in CONDS:
+				j -= 1
+				continue
+			if self.writes(insn, counter) or insn.mn in ('jp', 'jq', 'jr', 'djnz', 'ret'):
+				return None
+			j -= 1
+		if given and j + 1 == entry:
+			if counter in given:
+				return given[counter]
+			if counter in ('b', 'c') and 'bc' in given:
+				return (given['bc'] >> 8 if counter == 'b' else given['bc']) & 0xFF
+		return None
+
+	def repeat_count(self, i, entry=None, given=None):
+		"""bc for ldir and the like, when the straight line code before it or the caller sets a constant"""
+		insns = self.src.insns
+		j, low = i - 1, None
+		while j >= 0 and j + 1 not in self.entries:
+			insn = insns[j]
+			ops = [o.lower().replace(' ', '') for o in insn.ops]
+			if insn.mn in REPEAT:
+				return low or 0			# bc is zero after the one before
+			v = self.annotated(insn, 'bc')
+			if v is not None:
+				return (v & ~0xFF) | low if low is not None else v
+			if insn.mn == 'ld' and ops[0] == 'bc':
+				v = self.constant(insn.ops[1], insn.scope)
+				return None if v is None else (v & ~0xFF) | low if low is not None else v
+			if low is None and self.annotated(insn, 'c') is not None:
+				low = self.annotated(insn, 'c')
+			elif insn.mn == 'ld' and ops[0] == 'c' and low is None:
+				low = self.constant(insn.ops[1], insn.scope)
+				if low is None:
+					return None
+			elif self.writes(insn, 'b') or self.writes(insn, 'c') or insn.mn in ('jp', 'jq', 'jr', 'djnz', 'ret'):
+				return None
+			j -= 1
+		if given and j + 1 == entry and 'bc' in given:
+			v = given['bc']
+			return (v & ~0xFF) | low if low is not None else v
+		return None
+
+	def wcet(self, name, entry, result, given=None):
+		insns = self.src.insns
+		why = set()
+		cost, succ = {}, {}
+
+		def worst(callees, i, through=False):
+			most = 0
+			for callee in callees:
+				r = self.function(callee)
+				if r.cycles is None:
+					r = self.entered(callee, self.constants(i, entry, given, through))
+				if r.cycles is None:
+					why.update(r.cycle_why)
+					return None
+				most = max(most, r.cycles)
+			return most
+
+		# control flow within the function, with calls and tail calls folded into the costs
+		work = [entry]
+		while work:
+			i = work.pop()
+			if i in cost:
+				continue
+			insn = insns[i]
+			c, per, taken = timing(insn)
+			if insn.mn in REPEAT:
+				n = self.repeat_count(i, entry, given)
+				if n is None:
+					why.add('ldir in ' + name)
+				else:
+					c += per * (n or 0x1000000)
+			if insn.mn == 'call':
+				target = self.resolve(insn, insn.ops[-1])
+				if target == 'ti._frameset':
+					c += 12
+				elif target == 'ti._frameset0':
+					c += 12
+				else:
+					w = worst(self.callees(insn), i)
+					c = None if w is None else c + w
+			cost[i] = c
+			succ[i] = []
+			for kind, value, tk in self.flow(i, entry):
+				w = taken if tk else 0
+				if kind == 'jump':
+					succ[i].append((value, w))
+					work.append(value)
+				elif kind == 'tail' or (kind == 'ijump' and i not in self.returns):
+					through = kind == 'tail' and insn.mn not in ('jp', 'jq', 'jr', 'djnz', 'ret', 'reti', 'retn')
+					callee = worst([value] if kind == 'tail' else self.targets(insn), i, through)
+					if callee is not None:
+						succ[i].append((('exit', i), w + callee))
+				elif kind == 'stop':
+					why.add(value)
+		if why or any(c is None for c in cost.values()):
+			result.cycles = None
+			result.cycle_why = why
+			return
+
+		# loops, from the back edges of a depth first walk
+		pred = {}
+		for n, edges in succ.items():
+			for m, _ in edges:
+				pred.setdefault(m, set()).add(n)
+		back, state, stack = [], {entry: 1}, [(entry, iter(succ[entry]))]
+		while stack:
+			n, it = stack[-1]
+			for m, _ in it:
+				if isinstance(m, tuple):
+					continue
+				if state.get(m) == 1:
+					back.append((n, m))
+				elif m not in state:
+					state[m] = 1
+					stack.append((m, iter(succ[m])))
+					break
+			else:
+				state[n] = 2
+				stack.pop()
+		loops = []
+		ends = {}
+		for u, h in back:
+			ends.setdefault(h, []).append(u)
+		for h, us in ends.items():
+			bound = self.loop_bound(h, us, entry, given)
+			if bound is None:
+				why.add('loop in ' + name)
+				continue
+			u, count = bound
+			body, work = {h}, [u]
+			while work:
+				n = work.pop()
+				if n not in body:
+					body.add(n)
+					work.extend(pred.get(n, ()))
+			counter = self.loop_counter(u)
+			pair = PAIRS.get(counter)
+			changes = [n for n in body if n not in (u, u - 1) and self.writes(insns[n], counter)] if counter else []
+			saved = pair and all(insns[n].mn == 'pop' for n in changes) and any(
+				insns[n].mn == 'push' and pair in [o.lower() for o in insns[n].ops] for n in body)
+			# or pushed as the loop starts and popped just before it counts, whatever the body does
+			if not saved and pair:
+				k, last = h, u - 1 if insns[u].mn == 'djnz' else u - 2
+				while insns[k].mn not in ('push', 'jp', 'jq', 'jr', 'djnz', 'ret') and not self.writes(insns[k], counter):
+					k += 1
+				while insns[last].mn not in ('pop', 'jp', 'jq', 'jr', 'djnz', 'ret') and not self.writes(insns[last], counter):
+					last -= 1
+				saved = all(insns[n].mn in ('push', 'pop') and pair in [o.lower() for o in insns[n].ops] for n in (k, last))
+			if changes and not saved:
+				why.add('loop in ' + name)
+				continue
+			loops.append((body, h, u, count))
+		if why:
+			result.cycles = None
+			result.cycle_why = why
+			return
+
+		# collapse the loops, innermost first, then take the longest path through what is left
+		owner = {}
+		def find(n):
+			while n in owner:
+				n = owner[n]
+			return n
+		for body, h, u, count in sorted(loops, key=lambda l: len(l[0])):
+			nodes = {find(n) for n in body}
+			head, tail = find(h), find(u)
+			if any(find(p) not in nodes for n in nodes if n != head for p in pred.get(n, ())):
+				why.add('loop in ' + name)
+				break
+			per = self.longest(nodes, head, tail, cost, succ, find)
+			if per is None:
+				why.add('loop in ' + name)
+				break
+			exits = []
+			for n in nodes:
+				for m, w in succ[n]:
+					m = m if isinstance(m, tuple) else find(m)
+					if m not in nodes:
+						exits.append((m, w))
+			for n in nodes:
+				if n != head:
+					owner[n] = head
+			cost[head] = count * (per + timing(insns[u])[2])
+			succ[head] = exits
+			pred[head] = {p for n in nodes for p in pred.get(n, ()) if find(p) not in nodes}
+		if why:
+			result.cycles = None
+			result.cycle_why = why
+			return
+		total = self.longest(None, entry, None, cost, succ, find)
+		if total is None:
+			result.cycles = None
+			result.cycle_why = {'loop in ' + name}
+		else:
+			result.cycles = total
+
+	def loop_counter(self, u):
+		insn = self.src.insns[u]
+		if insn.mn == 'djnz':
+			return 'b'
+		ops = [o.lower().replace(' ', '') for o in insn.ops]
+		if insn.mn in ('jr', 'jp', 'jq') and ops[0] == 'nz':
+			prev = self.src.insns[u - 1]
+			pops = [o.lower().replace(' ', '') for o in prev.ops]
+			if prev.mn == 'dec' and len(pops) == 1 and (pops[0] in R8 | RI8 or operand_class(pops[0]) == 'mxy'):
+				return pops[0]
+		return None
+
+	def loop_bound(self, h, us, entry=None, given=None):
+		"""(the instruction closing the loop, its iteration count) if the loop has a constant bound"""
+		if len(us) != 1:
+			return None
+		u = us[0]
+		m = re.search(r'bound:\s*([^,;]+)', self.src.insns[u].comment)
+		if m:
+			count = self.src.evaluate(m.group(1), self.src.insns[u].scope)
+			return None if count is None else (u, count)
+		counter = self.loop_counter(u)
+		if counter is None:
+			return None
+		count = self.counter_init(h, counter, entry, given)
+		if count is None:
+			return None
+		return u, (count & 0xFF) or 256
+
+	@staticmethod
+	def longest(nodes, start, stop, cost, succ, find):
+		"""the most cycles on a path from start, to stop or to any way out, within nodes; None if it loops"""
+		memo, order = {}, [(start, False)]
+		while order:
+			n, done = order.pop()
+			if done:
+				best = 0 if n == stop else None
+				if n != stop:
+					for m, w in succ[n]:
+						if isinstance(m, tuple):
+							v = 0 if nodes is None else None
+						else:
+							m = find(m)
+							if nodes is not None and m not in nodes:
+								continue
+							v = memo.get(m)
+							if v == 'open':
+								return None
+						if v is not None:
+							best = w + v if best is None else max(best, w + v)
+					if nodes is None and best is None:
+						best = 0
+				memo[n] = None if best is None else best + cost[n]
+				continue
+			if n in memo:
+				if memo[n] == 'open':
+					return None
+				continue
+			memo[n] = 'open'
+			order.append((n, True))
+			if n == stop:
+				continue
+			for m, _ in succ[n]:
+				if isinstance(m, tuple):
+					continue
+				m = find(m)
+				if nodes is not None and m not in nodes:
+					continue
+				if m not in memo:
+					order.append((m, False))
+				elif memo[m] == 'open':
+					return None
+		return memo.get(start)
+
+
+def main():
+	path = sys.argv[1] if len(sys.argv) > 1 else 'cryptx.asm'
+	src = Source(path)
+	analyzer = Analyzer(src)
+	rows, blocks = [], []
+	for export in src.exports + [label for label, _ in BLOCKS]:
+		label = analyzer.resolve(Insn(0, '', '', [], ''), export)
+		if label is None:
+			continue
+		r = analyzer.function(label)
+		stack = '%d%s' % (r.stack + 3, '+' if r.stack_why else '')
+		cycles = '-' if r.cycles is None else str(r.cycles + timing(Insn(0, '', 'call', ['x'], ''))[0])
+		why = r.stack_why | r.cycle_why
+		notes = sorted(n for n in why if not n.startswith(('ti.', 'loop in ', 'ldir in ')))
+		if any(n.startswith('ti.') for n in why):
+			notes.append('runtime')
+		loops = sorted({n.split(' in ', 1)[1] for n in why if n.startswith(('loop in ', 'ldir in '))})
+		if loops:
+			notes.append('loops: ' + ' '.join(loops))
+		(blocks if export in dict(BLOCKS) else rows).append((export, stack, cycles, ', '.join(notes)))
+	w0 = max(len(r[0]) for r in rows + blocks)
+	print('; generated by tools/stackreport.py from %s, do not edit' % path.split('/')[-1])
+	print(';')
+	print('; stack: bytes used below the caller\'s stack pointer once the arguments are pushed, return address included')
+	print('; cycles: worst case at zero wait states, including the call; - if a loop or a callee has no static bound')
+	print('; notes: why a stack figure is a lower bound (+) or why there is no cycle figure')
+	print(';   callback   calls a function pointer supplied by the program')
+	print(';   dynamic    moves the stack pointer by an amount computed at run time')
+	print(';   os         calls into the OS')
+	print(';   runtime    calls toolchain runtime routines (ti._*), each counted as %d bytes of stack' % RUNTIME_STACK)
+	print(';   loops: f   f has a loop, ldir or lddr whose bound depends on its inputs')
+	print()
+	print('%-*s  %6s  %10s  %s' % (w0, 'export', 'stack', 'cycles', 'notes'))
+	for export, stack, cycles, notes in rows:
+		print(('%-*s  %6s  %10s  %s' % (w0, export, stack, cycles, notes)).rstrip())
+	print()
+	print('; run by the exports above once a block, for a figure at a given length')
+	print()
+	print('%-*s  %6s  %10s  %s' % (w0, 'block', 'stack', 'cycles', 'notes'))
+	for label, stack, cycles, notes in blocks:
+		notes = ', '.join(n for n in (dict(BLOCKS)[label], notes) if n)
+		print(('%-*s  %6s  %10s  %s' % (w0, label, stack, cycles, notes)).rstrip())
+
+
+if __name__ == '__main__':
+	main()